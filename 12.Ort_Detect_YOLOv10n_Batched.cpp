@@ -0,0 +1,257 @@
+/*
+
+Why do we need batched inference?
+----------------------------------------------------
+10.Ort_Detect_YOLOv10n.cpp builds a {1, 3, 640, 640} tensor and calls session.Run once per image. Every Run call pays a fixed
+overhead (input validation, execution plan setup, thread pool wake-up), and with a single image most convolution kernels are too
+small to keep all CPU cores busy.
+
+Batching packs N preprocessed images into one [N, 3, 640, 640] tensor, so a single Run call processes all of them:
+
+    - The per-Run overhead is paid once per batch instead of once per image.
+    - Larger GEMMs give the intra-op thread pool more parallel work to share across cores.
+    - The last batch may be partial: the same buffer is reused with a smaller leading dimension.
+
+The model returns [N, 300, 6] (x1, y1, x2, y2, conf, class_id in 640x640 space). The output is split back per image and every
+box is scaled to that image's original width/height.
+
+NOTE: the model must be exported with a dynamic batch axis (e.g. `yolo export model=yolov10n.pt format=onnx dynamic=True`).
+      A model with a fixed batch of 1 is detected and reported at startup.
+
+Usage:
+    ./ort_yolo10n_batched                        -> throughput comparison of batch sizes 1/4/8/16 on car.png
+    ./ort_yolo10n_batched <batch_size> <img...>  -> detect on the given images with the given batch size
+
+*/
+
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include <onnxruntime_cxx_api.h>
+#include <opencv2/opencv.hpp>
+
+struct Detection {
+    cv::Rect box;   // in original image coordinates
+    float conf;
+    int class_id;
+};
+
+// Resize + normalize one image and write it (HWC -> CHW) into its slot of the batch buffer
+void preprocessInto(const cv::Mat& image, float* dst, int input_w, int input_h) {
+    cv::Mat resized;
+    cv::resize(image, resized, cv::Size(input_w, input_h));
+    resized.convertTo(resized, CV_32F, 1.0 / 255.0);
+
+    // cv::split writes into Mats that wrap the batch buffer, so no extra copy is made
+    const size_t plane = static_cast<size_t>(input_w) * input_h;
+    std::vector<cv::Mat> channels = {
+        cv::Mat(input_h, input_w, CV_32F, dst),
+        cv::Mat(input_h, input_w, CV_32F, dst + plane),
+        cv::Mat(input_h, input_w, CV_32F, dst + 2 * plane)};
+    cv::split(resized, channels);
+}
+
+// Run one (possibly partial) batch of images[begin, begin + count) and return detections per image
+std::vector<std::vector<Detection>> runBatch(Ort::Session& session,
+                                             const char* const* input_names,
+                                             const char* const* output_names,
+                                             const std::vector<cv::Mat>& images,
+                                             size_t begin, size_t count,
+                                             std::vector<float>& batch_buffer,
+                                             int input_w, int input_h,
+                                             float conf_threshold) {
+    const size_t image_size = 3 * static_cast<size_t>(input_w) * input_h;
+
+    for (size_t i = 0; i < count; i++) {
+        preprocessInto(images[begin + i], batch_buffer.data() + i * image_size, input_w, input_h);
+    }
+
+    // Partial last batch: same buffer, smaller leading dimension
+    std::vector<int64_t> input_shape = {static_cast<int64_t>(count), 3, input_h, input_w};
+
+    Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+    Ort::Value input_tensor = Ort::Value::CreateTensor<float>(
+        memory_info, batch_buffer.data(), count * image_size,
+        input_shape.data(), input_shape.size());
+
+    auto output_tensors = session.Run(
+        Ort::RunOptions{nullptr},
+        input_names, &input_tensor, 1,
+        output_names, 1);
+
+    // Output is [N, 300, 6]
+    const float* output_data = output_tensors[0].GetTensorData<float>();
+    auto output_shape = output_tensors[0].GetTensorTypeAndShapeInfo().GetShape();
+    const int64_t num_dets = output_shape[1];
+    const int64_t num_attrs = output_shape[2];
+
+    std::vector<std::vector<Detection>> results(count);
+    for (size_t b = 0; b < count; b++) {
+        const cv::Mat& image = images[begin + b];
+        const float sx = static_cast<float>(image.cols) / input_w;
+        const float sy = static_cast<float>(image.rows) / input_h;
+        const float* dets = output_data + b * num_dets * num_attrs;
+
+        for (int64_t i = 0; i < num_dets; i++) {
+            const float* d = dets + i * num_attrs;
+            if (d[4] < conf_threshold) continue;
+
+            // Map from 640x640 model space back to this image's original coordinates
+            int x1 = static_cast<int>(d[0] * sx);
+            int y1 = static_cast<int>(d[1] * sy);
+            int x2 = static_cast<int>(d[2] * sx);
+            int y2 = static_cast<int>(d[3] * sy);
+            results[b].push_back({cv::Rect(x1, y1, x2 - x1, y2 - y1), d[4], static_cast<int>(d[5])});
+        }
+    }
+    return results;
+}
+
+// Process all images in batches of batch_size; returns detections per image
+std::vector<std::vector<Detection>> detectAll(Ort::Session& session,
+                                              const char* const* input_names,
+                                              const char* const* output_names,
+                                              const std::vector<cv::Mat>& images,
+                                              size_t batch_size,
+                                              int input_w, int input_h,
+                                              float conf_threshold) {
+    std::vector<float> batch_buffer(batch_size * 3 * static_cast<size_t>(input_w) * input_h);
+    std::vector<std::vector<Detection>> all;
+    all.reserve(images.size());
+
+    for (size_t begin = 0; begin < images.size(); begin += batch_size) {
+        size_t count = std::min(batch_size, images.size() - begin);
+        auto batch = runBatch(session, input_names, output_names, images, begin, count,
+                              batch_buffer, input_w, input_h, conf_threshold);
+        for (auto& dets : batch) all.push_back(std::move(dets));
+    }
+    return all;
+}
+
+void drawDetections(cv::Mat& image, const std::vector<Detection>& dets) {
+    for (const auto& d : dets) {
+        cv::rectangle(image, d.box, cv::Scalar(0, 255, 0), 2);
+        cv::putText(image,
+                    "cls " + std::to_string(d.class_id) + ":" + cv::format("%.2f", d.conf),
+                    cv::Point(d.box.x, d.box.y - 5),
+                    cv::FONT_HERSHEY_SIMPLEX, 0.5,
+                    cv::Scalar(255, 0, 0), 1);
+    }
+}
+
+// ---------------- Main ----------------
+int main(int argc, char** argv) {
+    try {
+        std::cout << "--- YOLOv10 ONNX Batched Inference Demo ---" << std::endl;
+
+        const int input_w = 640, input_h = 640;
+        const float conf_threshold = 0.25f;
+
+        // 1. ORT Environment + Session
+        Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "YOLOv10BatchDemo");
+        Ort::SessionOptions session_options;
+        session_options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+
+        const std::string model_path = "/assets/models/yolov10n.onnx";
+        Ort::Session session(env, model_path.c_str(), session_options);
+
+        // 2. Check that the model accepts a dynamic batch dimension
+        auto model_input_shape = session.GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+        const bool dynamic_batch = model_input_shape[0] < 0;
+        if (!dynamic_batch) {
+            std::cout << "Model has a fixed batch of " << model_input_shape[0]
+                      << "; re-export with dynamic=True to use batch sizes > 1." << std::endl;
+        }
+
+        Ort::AllocatorWithDefaultOptions allocator;
+        auto input_name_alloc = session.GetInputNameAllocated(0, allocator);
+        auto output_name_alloc = session.GetOutputNameAllocated(0, allocator);
+        const char* input_names[] = {input_name_alloc.get()};
+        const char* output_names[] = {output_name_alloc.get()};
+
+        // 3. Detection mode: explicit batch size and image list
+        if (argc >= 3) {
+            size_t batch_size = static_cast<size_t>(std::max(1, std::atoi(argv[1])));
+            if (!dynamic_batch) batch_size = 1;
+
+            std::vector<std::string> paths(argv + 2, argv + argc);
+            std::vector<cv::Mat> images;
+            for (const auto& p : paths) {
+                cv::Mat img = cv::imread(p);
+                if (img.empty()) {
+                    std::cerr << " Error: could not load image at " << p << std::endl;
+                    return -1;
+                }
+                images.push_back(img);
+            }
+
+            auto results = detectAll(session, input_names, output_names, images,
+                                     batch_size, input_w, input_h, conf_threshold);
+
+            for (size_t i = 0; i < images.size(); i++) {
+                drawDetections(images[i], results[i]);
+                const std::string out_path = "/assets/output/batched_" + std::to_string(i) + ".jpg";
+                cv::imwrite(out_path, images[i]);
+                std::cout << paths[i] << ": " << results[i].size() << " detections -> " << out_path << std::endl;
+            }
+            return 0;
+        }
+
+        // 4. Benchmark mode: batch sizes 1/4/8/16 on the bundled car.png
+        const std::string image_path = "/assets/images/car.png";
+        cv::Mat image = cv::imread(image_path);
+        if (image.empty()) {
+            std::cerr << " Error: could not load image at " << image_path << std::endl;
+            return -1;
+        }
+
+        const size_t num_images = 48;   // divisible by 1/4/8/16, so every size runs full batches
+        std::vector<cv::Mat> images(num_images, image);
+
+        std::cout << "Images per run: " << num_images << std::endl;
+        std::cout << "batch | total ms | ms/image | images/s | speedup" << std::endl;
+
+        double baseline_ips = 0.0;
+        std::vector<std::vector<Detection>> last_results;
+        for (size_t batch_size : {1, 4, 8, 16}) {
+            if (!dynamic_batch && batch_size > 1) break;
+
+            // Warm-up: first Run for each new shape pays allocation/planning cost
+            std::vector<cv::Mat> warm(images.begin(), images.begin() + batch_size);
+            detectAll(session, input_names, output_names, warm, batch_size, input_w, input_h, conf_threshold);
+
+            auto t0 = std::chrono::steady_clock::now();
+            last_results = detectAll(session, input_names, output_names, images,
+                                     batch_size, input_w, input_h, conf_threshold);
+            auto t1 = std::chrono::steady_clock::now();
+
+            double total_ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+            double ips = num_images * 1000.0 / total_ms;
+            if (batch_size == 1) baseline_ips = ips;
+
+            std::cout << cv::format("%5zu | %8.1f | %8.2f | %8.1f | %6.2fx",
+                                    batch_size, total_ms, total_ms / num_images, ips, ips / baseline_ips)
+                      << std::endl;
+        }
+
+        // 5. Save the first image's detections (boxes already in original coordinates)
+        drawDetections(image, last_results.front());
+        const std::string output_path = "/assets/output/yolov10_car_batched_output.jpg";
+        cv::imwrite(output_path, image);
+        std::cout << " Detection complete. Saved as " << output_path << std::endl;
+    }
+    catch (const Ort::Exception& e) {
+        std::cerr << "ONNX Runtime error: " << e.what() << std::endl;
+        return -1;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Standard exception: " << e.what() << std::endl;
+        return -1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,417 @@
+/*
+
+Why do we need a fused preprocessing kernel?
+----------------------------------------------------
+10.Ort_Detect_YOLOv10n.cpp prepares its input with four full passes over the image:
+
+    1. cv::resize                    -> 640x640x3 uint8
+    2. convertTo(CV_32F, 1/255)      -> 640x640x3 float   (4x the bytes of step 1)
+    3. cv::split                     -> three 640x640 float Mats
+    4. std::vector::insert per plane -> another copy into input_tensor_values
+
+Every pass streams the whole image through the cache, and steps 2-4 move ~5 MB each. On small models like YOLOv10n this can
+take longer than session.Run itself.
+
+The fused kernel below does all four steps in a single pass: for every output pixel it bilinearly samples the BGR uint8 source,
+scales by 1/255 and writes the three channels straight into their CHW planes of the ORT input tensor. Nothing else is allocated:
+the horizontal sampling tables depend only on (source width, output width), so they are built on the first frame and cached per
+thread until the frame size changes.
+
+    - Stretch mode  : same geometry as cv::resize(image, {640, 640}), as used by the original demo.
+    - Letterbox mode: aspect-preserving resize, centered, padded with gray (114) like the Ultralytics exporters expect.
+    - SIMD dispatch : AVX-512 / AVX2 / scalar is chosen at runtime with __builtin_cpu_supports, so one binary runs everywhere.
+
+The demo benchmarks the fused kernel against the original OpenCV chain, checks that both produce the same tensor, and then
+runs YOLOv10n on a tensor filled in place by the kernel.
+
+*/
+
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <onnxruntime_cxx_api.h>
+#include <opencv2/opencv.hpp>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define FUSED_X86 1
+#endif
+
+enum class SimdLevel { Scalar, AVX2, AVX512 };
+
+const char* simdName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::AVX512: return "AVX-512";
+        case SimdLevel::AVX2:   return "AVX2";
+        default:                return "Scalar";
+    }
+}
+
+SimdLevel detectSimd() {
+#ifdef FUSED_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return SimdLevel::AVX512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return SimdLevel::AVX2;
+#endif
+    return SimdLevel::Scalar;
+}
+
+// Where the resized image landed inside the model input (needed to map boxes back)
+struct LetterboxInfo {
+    float scale_x, scale_y;   // model pixels per source pixel
+    int pad_x, pad_y;         // left/top padding in model pixels
+};
+
+// Horizontal sampling table for one output row, shared by all rows
+struct ResizeTables {
+    std::vector<int32_t> x0_off;   // byte offset of left sample (x0 * 3)
+    std::vector<int32_t> x1_off;   // byte offset of right sample (x1 * 3)
+    std::vector<float> fx;         // weight of right sample
+    int vec_end;                   // first x whose 4-byte gather would read past the row end
+};
+
+// OpenCV INTER_LINEAR convention: half-pixel centers, clamped at the borders
+static void sampleCoord(int dst, float scale, int src_len, int& i0, int& i1, float& f) {
+    float s = (dst + 0.5f) * scale - 0.5f;
+    if (s < 0.f) s = 0.f;
+    i0 = static_cast<int>(s);
+    f = s - i0;
+    if (i0 >= src_len - 1) {
+        i0 = src_len - 1;
+        f = 0.f;
+    }
+    i1 = std::min(i0 + 1, src_len - 1);
+}
+
+static ResizeTables buildTables(int src_w, int out_w) {
+    ResizeTables t;
+    t.x0_off.resize(out_w);
+    t.x1_off.resize(out_w);
+    t.fx.resize(out_w);
+    t.vec_end = out_w;
+
+    const float scale = static_cast<float>(src_w) / out_w;
+    bool found_end = false;
+    for (int x = 0; x < out_w; x++) {
+        int x0, x1;
+        sampleCoord(x, scale, src_w, x0, x1, t.fx[x]);
+        t.x0_off[x] = x0 * 3;
+        t.x1_off[x] = x1 * 3;
+        // A 32-bit gather at the last pixel reads one byte past the row; leave those columns to the scalar tail
+        if (!found_end && x1 >= src_w - 1) {
+            t.vec_end = x;
+            found_end = true;
+        }
+    }
+    return t;
+}
+
+// A camera stream keeps its frame size, so the tables are rebuilt (and allocated) only when (src_w, out_w) changes
+static const ResizeTables& cachedTables(int src_w, int out_w) {
+    thread_local ResizeTables tables;
+    thread_local int cached_src_w = -1, cached_out_w = -1;
+    if (src_w != cached_src_w || out_w != cached_out_w) {
+        tables = buildTables(src_w, out_w);
+        cached_src_w = src_w;
+        cached_out_w = out_w;
+    }
+    return tables;
+}
+
+// ---------------- Row kernels ----------------
+// Each kernel fills output columns [x_begin, x_end) of one row in the three CHW planes.
+
+static void rowScalar(const uint8_t* s0, const uint8_t* s1, float fy, const ResizeTables& t,
+                      int x_begin, int x_end, float* d0, float* d1, float* d2) {
+    const float inv255 = 1.0f / 255.0f;
+    float* dst[3] = {d0, d1, d2};
+    for (int x = x_begin; x < x_end; x++) {
+        const int a = t.x0_off[x], b = t.x1_off[x];
+        const float fx = t.fx[x];
+        for (int c = 0; c < 3; c++) {
+            float top = s0[a + c] + (s0[b + c] - s0[a + c]) * fx;
+            float bot = s1[a + c] + (s1[b + c] - s1[a + c]) * fx;
+            dst[c][x] = (top + (bot - top) * fy) * inv255;
+        }
+    }
+}
+
+#ifdef FUSED_X86
+__attribute__((target("avx2,fma")))
+static void rowAVX2(const uint8_t* s0, const uint8_t* s1, float fy, const ResizeTables& t,
+                    int x_begin, int x_end, float* d0, float* d1, float* d2) {
+    const __m256 inv255 = _mm256_set1_ps(1.0f / 255.0f);
+    const __m256 wy = _mm256_set1_ps(fy);
+    const __m256i mask = _mm256_set1_epi32(0xFF);
+    const int* r0 = reinterpret_cast<const int*>(s0);
+    const int* r1 = reinterpret_cast<const int*>(s1);
+    float* dst[3] = {d0, d1, d2};
+
+    const int vec_end = std::min(x_end, t.vec_end);
+    int x = x_begin;
+    for (; x + 8 <= vec_end; x += 8) {
+        // One gather per corner loads B,G,R (+1 spare byte) of 8 pixels
+        const __m256i i0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&t.x0_off[x]));
+        const __m256i i1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&t.x1_off[x]));
+        const __m256 wx = _mm256_loadu_ps(&t.fx[x]);
+        const __m256i p00 = _mm256_i32gather_epi32(r0, i0, 1);
+        const __m256i p01 = _mm256_i32gather_epi32(r0, i1, 1);
+        const __m256i p10 = _mm256_i32gather_epi32(r1, i0, 1);
+        const __m256i p11 = _mm256_i32gather_epi32(r1, i1, 1);
+
+        for (int c = 0; c < 3; c++) {
+            const __m128i shift = _mm_cvtsi32_si128(8 * c);
+            __m256 a = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srl_epi32(p00, shift), mask));
+            __m256 b = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srl_epi32(p01, shift), mask));
+            __m256 e = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srl_epi32(p10, shift), mask));
+            __m256 f = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srl_epi32(p11, shift), mask));
+            __m256 top = _mm256_fmadd_ps(_mm256_sub_ps(b, a), wx, a);
+            __m256 bot = _mm256_fmadd_ps(_mm256_sub_ps(f, e), wx, e);
+            __m256 v = _mm256_fmadd_ps(_mm256_sub_ps(bot, top), wy, top);
+            _mm256_storeu_ps(dst[c] + x, _mm256_mul_ps(v, inv255));
+        }
+    }
+    rowScalar(s0, s1, fy, t, x, x_end, d0, d1, d2);
+}
+
+__attribute__((target("avx512f")))
+static void rowAVX512(const uint8_t* s0, const uint8_t* s1, float fy, const ResizeTables& t,
+                      int x_begin, int x_end, float* d0, float* d1, float* d2) {
+    const __m512 inv255 = _mm512_set1_ps(1.0f / 255.0f);
+    const __m512 wy = _mm512_set1_ps(fy);
+    const __m512i mask = _mm512_set1_epi32(0xFF);
+    float* dst[3] = {d0, d1, d2};
+
+    const int vec_end = std::min(x_end, t.vec_end);
+    int x = x_begin;
+    for (; x + 16 <= vec_end; x += 16) {
+        const __m512i i0 = _mm512_loadu_si512(&t.x0_off[x]);
+        const __m512i i1 = _mm512_loadu_si512(&t.x1_off[x]);
+        const __m512 wx = _mm512_loadu_ps(&t.fx[x]);
+        const __m512i p00 = _mm512_i32gather_epi32(i0, s0, 1);
+        const __m512i p01 = _mm512_i32gather_epi32(i1, s0, 1);
+        const __m512i p10 = _mm512_i32gather_epi32(i0, s1, 1);
+        const __m512i p11 = _mm512_i32gather_epi32(i1, s1, 1);
+
+        for (int c = 0; c < 3; c++) {
+            const __m128i shift = _mm_cvtsi32_si128(8 * c);
+            __m512 a = _mm512_cvtepi32_ps(_mm512_and_si512(_mm512_srl_epi32(p00, shift), mask));
+            __m512 b = _mm512_cvtepi32_ps(_mm512_and_si512(_mm512_srl_epi32(p01, shift), mask));
+            __m512 e = _mm512_cvtepi32_ps(_mm512_and_si512(_mm512_srl_epi32(p10, shift), mask));
+            __m512 f = _mm512_cvtepi32_ps(_mm512_and_si512(_mm512_srl_epi32(p11, shift), mask));
+            __m512 top = _mm512_fmadd_ps(_mm512_sub_ps(b, a), wx, a);
+            __m512 bot = _mm512_fmadd_ps(_mm512_sub_ps(f, e), wx, e);
+            __m512 v = _mm512_fmadd_ps(_mm512_sub_ps(bot, top), wy, top);
+            _mm512_storeu_ps(dst[c] + x, _mm512_mul_ps(v, inv255));
+        }
+    }
+    rowScalar(s0, s1, fy, t, x, x_end, d0, d1, d2);
+}
+#endif
+
+// ---------------- Fused kernel ----------------
+// Reads packed BGR uint8 (src_step bytes per row) and writes normalized planar float [3, dst_h, dst_w] into dst.
+LetterboxInfo fusedPreprocess(const uint8_t* src, int src_w, int src_h, size_t src_step,
+                              float* dst, int dst_w, int dst_h,
+                              bool letterbox, SimdLevel level) {
+    LetterboxInfo info{static_cast<float>(dst_w) / src_w, static_cast<float>(dst_h) / src_h, 0, 0};
+    int out_w = dst_w, out_h = dst_h;
+
+    if (letterbox) {
+        const float r = std::min(info.scale_x, info.scale_y);
+        out_w = std::max(1, static_cast<int>(std::round(src_w * r)));
+        out_h = std::max(1, static_cast<int>(std::round(src_h * r)));
+        info = {static_cast<float>(out_w) / src_w, static_cast<float>(out_h) / src_h,
+                (dst_w - out_w) / 2, (dst_h - out_h) / 2};
+    }
+
+    auto row = rowScalar;
+#ifdef FUSED_X86
+    if (level == SimdLevel::AVX512) row = rowAVX512;
+    else if (level == SimdLevel::AVX2) row = rowAVX2;
+#endif
+
+    const ResizeTables& t = cachedTables(src_w, out_w);
+    const float scale_y = static_cast<float>(src_h) / out_h;
+    const size_t plane = static_cast<size_t>(dst_w) * dst_h;
+    const float pad_value = 114.0f / 255.0f;
+
+    for (int y = 0; y < dst_h; y++) {
+        float* d0 = dst + static_cast<size_t>(y) * dst_w;
+        float* d1 = d0 + plane;
+        float* d2 = d1 + plane;
+
+        const int oy = y - info.pad_y;
+        if (oy < 0 || oy >= out_h) {
+            std::fill(d0, d0 + dst_w, pad_value);
+            std::fill(d1, d1 + dst_w, pad_value);
+            std::fill(d2, d2 + dst_w, pad_value);
+            continue;
+        }
+        if (info.pad_x > 0) {
+            for (float* d : {d0, d1, d2}) {
+                std::fill(d, d + info.pad_x, pad_value);
+                std::fill(d + info.pad_x + out_w, d + dst_w, pad_value);
+            }
+        }
+
+        int y0, y1;
+        float fy;
+        sampleCoord(oy, scale_y, src_h, y0, y1, fy);
+        row(src + y0 * src_step, src + y1 * src_step, fy, t, 0, out_w,
+            d0 + info.pad_x, d1 + info.pad_x, d2 + info.pad_x);
+    }
+    return info;
+}
+
+LetterboxInfo fusedPreprocess(const cv::Mat& bgr, float* dst, int dst_w, int dst_h,
+                              bool letterbox, SimdLevel level) {
+    return fusedPreprocess(bgr.ptr<uint8_t>(), bgr.cols, bgr.rows, bgr.step,
+                           dst, dst_w, dst_h, letterbox, level);
+}
+
+// ---------------- Reference: the original OpenCV chain from 10.Ort_Detect_YOLOv10n.cpp ----------------
+void opencvPreprocess(const cv::Mat& image, std::vector<float>& input_tensor_values, int input_w, int input_h) {
+    cv::Mat resized;
+    cv::resize(image, resized, cv::Size(input_w, input_h));
+    resized.convertTo(resized, CV_32F, 1.0 / 255.0);
+
+    input_tensor_values.clear();
+    std::vector<cv::Mat> channels(3);
+    cv::split(resized, channels);
+    for (int c = 0; c < 3; c++) {
+        input_tensor_values.insert(input_tensor_values.end(),
+                                   (float*)channels[c].datastart,
+                                   (float*)channels[c].dataend);
+    }
+}
+
+template <typename Fn>
+double benchmarkMs(Fn&& fn, int iterations) {
+    fn();   // warm-up
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) fn();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(t1 - t0).count() / iterations;
+}
+
+// ---------------- Main ----------------
+int main() {
+    try {
+        std::cout << "--- Fused SIMD Preprocessing Demo ---" << std::endl;
+
+        const int input_w = 640, input_h = 640;
+        const size_t tensor_size = 3 * static_cast<size_t>(input_w) * input_h;
+        const int iterations = 200;
+
+        // 1. Load input image
+        const std::string image_path = "/assets/images/car.png";
+        cv::Mat image = cv::imread(image_path);
+        if (image.empty()) {
+            std::cerr << " Error: could not load image at " << image_path << std::endl;
+            return -1;
+        }
+        std::cout << "Image: " << image.cols << "x" << image.rows
+                  << " | Best SIMD level: " << simdName(detectSimd()) << std::endl;
+
+        // 2. Micro-benchmark: OpenCV chain vs fused kernel at every supported SIMD level
+        std::vector<float> reference;
+        double cv_ms = benchmarkMs([&] { opencvPreprocess(image, reference, input_w, input_h); }, iterations);
+        std::cout << cv::format("%-22s %8.3f ms  (1.00x)", "OpenCV 4-pass chain", cv_ms) << std::endl;
+
+        std::vector<float> fused(tensor_size);
+        std::vector<SimdLevel> levels = {SimdLevel::Scalar};
+        if (detectSimd() != SimdLevel::Scalar) levels.push_back(SimdLevel::AVX2);
+        if (detectSimd() == SimdLevel::AVX512) levels.push_back(SimdLevel::AVX512);
+
+        for (SimdLevel level : levels) {
+            double ms = benchmarkMs([&] {
+                fusedPreprocess(image, fused.data(), input_w, input_h, false, level);
+            }, iterations);
+
+            // OpenCV uses 11-bit fixed-point weights for uint8 resize, so allow a small difference
+            float max_diff = 0.f;
+            for (size_t i = 0; i < tensor_size; i++) {
+                max_diff = std::max(max_diff, std::fabs(fused[i] - reference[i]));
+            }
+            std::cout << cv::format("Fused %-16s %8.3f ms  (%.2fx)  max |diff| vs OpenCV = %.4f",
+                                    simdName(level), ms, cv_ms / ms, max_diff) << std::endl;
+        }
+
+        double lb_ms = benchmarkMs([&] {
+            fusedPreprocess(image, fused.data(), input_w, input_h, true, detectSimd());
+        }, iterations);
+        std::cout << cv::format("Fused letterbox (%s) %6.3f ms", simdName(detectSimd()), lb_ms) << std::endl;
+
+        // 3. ORT session; the kernel writes straight into the tensor's own buffer
+        Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "FusedPreprocessDemo");
+        Ort::SessionOptions session_options;
+        session_options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+
+        const std::string model_path = "/assets/models/yolov10n.onnx";
+        Ort::Session session(env, model_path.c_str(), session_options);
+
+        Ort::AllocatorWithDefaultOptions allocator;
+        std::vector<int64_t> input_shape = {1, 3, input_h, input_w};
+        Ort::Value input_tensor = Ort::Value::CreateTensor<float>(allocator, input_shape.data(), input_shape.size());
+
+        LetterboxInfo lb = fusedPreprocess(image, input_tensor.GetTensorMutableData<float>(),
+                                           input_w, input_h, true, detectSimd());
+
+        auto input_name_alloc = session.GetInputNameAllocated(0, allocator);
+        auto output_name_alloc = session.GetOutputNameAllocated(0, allocator);
+        const char* input_names[] = {input_name_alloc.get()};
+        const char* output_names[] = {output_name_alloc.get()};
+
+        auto output_tensors = session.Run(
+            Ort::RunOptions{nullptr},
+            input_names, &input_tensor, 1,
+            output_names, 1);
+
+        // 4. Parse output and undo the letterbox: original = (model - pad) / scale
+        const float* output_data = output_tensors[0].GetTensorData<float>();
+        auto output_shape = output_tensors[0].GetTensorTypeAndShapeInfo().GetShape();
+        int num_dets = output_shape[1];
+        int num_attrs = output_shape[2];
+
+        for (int i = 0; i < num_dets; i++) {
+            const float* d = output_data + i * num_attrs;
+            float conf = d[4];
+            if (conf < 0.25f) continue;
+
+            float x1 = (d[0] - lb.pad_x) / lb.scale_x;
+            float y1 = (d[1] - lb.pad_y) / lb.scale_y;
+            float x2 = (d[2] - lb.pad_x) / lb.scale_x;
+            float y2 = (d[3] - lb.pad_y) / lb.scale_y;
+            int class_id = static_cast<int>(d[5]);
+
+            cv::Rect box((int)x1, (int)y1, (int)(x2 - x1), (int)(y2 - y1));
+            cv::rectangle(image, box, cv::Scalar(0, 255, 0), 2);
+            cv::putText(image,
+                        "cls " + std::to_string(class_id) + ":" + cv::format("%.2f", conf),
+                        cv::Point((int)x1, (int)y1 - 5),
+                        cv::FONT_HERSHEY_SIMPLEX, 0.5,
+                        cv::Scalar(255, 0, 0), 1);
+        }
+
+        // 5. Save result
+        const std::string output_path = "/assets/output/yolov10_car_fused_output.jpg";
+        cv::imwrite(output_path, image);
+        std::cout << " Detection complete. Saved as " << output_path << std::endl;
+    }
+    catch (const Ort::Exception& e) {
+        std::cerr << "ONNX Runtime error: " << e.what() << std::endl;
+        return -1;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Standard exception: " << e.what() << std::endl;
+        return -1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,503 @@
+/*
+
+Why do we need a multi-stage streaming pipeline?
+----------------------------------------------------
+10.Ort_Detect_YOLOv10n.cpp handles one hard-coded image in strict sequence: decode -> preprocess -> session.Run -> draw -> imwrite.
+While the model runs, the decoder and encoder sit idle, and while a JPEG is being decoded or encoded the model sits idle.
+
+This demo splits the work into five stages. Each stage has its own thread count, and bounded lock-free queues connect them:
+
+    [decode] --q--> [preprocess] --q--> [inference] --q--> [postprocess] --q--> [encode]
+
+    - decode      : cv::imread over a directory (parallel) or cv::VideoCapture over a video file (one thread).
+    - preprocess  : resize + normalize + HWC -> CHW into a per-frame float buffer.
+    - inference   : session.Run on one shared Ort::Session (Run is thread-safe).
+    - postprocess : parse the [1, 300, 6] output, map boxes to original coordinates, draw them.
+    - encode      : cv::imwrite of frame_XXXXXX.jpg into the output directory.
+
+Every queue is a fixed-capacity multi-producer/multi-consumer ring buffer (Vyukov's bounded MPMC queue). A producer facing a full
+queue (or a consumer facing an empty one) spins for a short while, then sleeps on a condition variable, so idle stages leave the
+cores to session.Run. A slow stage applies back-pressure instead of letting memory grow. When all producers of a queue finish, its
+consumers drain it and stop. If any stage throws, every queue is closed, all stages stop, and main rethrows the error.
+
+At the end the demo prints, for every stage, its throughput and utilization (busy time / (wall time * threads)). For every queue
+it prints the average and maximum occupancy. A stage near 100% utilization with a full queue in front of it and an empty queue
+after it is the bottleneck.
+
+Usage:
+    ./ort_yolo10n_pipeline <video file | image dir> <output dir> [decode pre infer post encode threads] [queue capacity]
+    ./ort_yolo10n_pipeline                                    -> /assets/images -> /assets/output/pipeline
+
+*/
+
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <chrono>
+#include <algorithm>
+#include <filesystem>
+#include <functional>
+#include <cstdlib>
+#include <cctype>
+#include <onnxruntime_cxx_api.h>
+#include <opencv2/opencv.hpp>
+
+namespace fs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+
+// ---------------- Bounded lock-free MPMC queue ----------------
+template <typename T>
+class BoundedQueue {
+public:
+    // capacity is rounded up to a power of two; producers = number of threads that will push
+    BoundedQueue(size_t capacity, int producers) : producers_(producers) {
+        size_t cap = 2;
+        while (cap < capacity) cap <<= 1;
+        mask_ = cap - 1;
+        cells_.reset(new Cell[cap]);
+        for (size_t i = 0; i < cap; i++) cells_[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    bool tryPush(T& value) {
+        size_t pos = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos & mask_];
+            size_t seq = cell.seq.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.data = std::move(value);
+                    cell.seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;   // full
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool tryPop(T& out) {
+        size_t pos = head_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos & mask_];
+            size_t seq = cell.seq.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    out = std::move(cell.data);
+                    cell.seq.store(pos + mask_ + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;   // empty
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Blocking push: back-pressure on the producer while the queue is full. Returns false if the queue was closed.
+    bool push(T value) {
+        for (int spin = 0;; spin++) {
+            if (closed_.load(std::memory_order_acquire)) return false;
+            if (tryPush(value)) {
+                notify(not_empty_);
+                return true;
+            }
+            if (spin < kSpinLimit) std::this_thread::yield();
+            else sleep(not_full_, [this] { return canPush(); });
+        }
+    }
+
+    // Blocking pop: returns false once every producer is done and the queue is drained, or the queue was closed
+    bool pop(T& out) {
+        for (int spin = 0;; spin++) {
+            if (closed_.load(std::memory_order_acquire)) return false;
+            if (tryPop(out) || (producers_.load(std::memory_order_acquire) == 0 && tryPop(out))) {
+                notify(not_full_);
+                return true;
+            }
+            if (producers_.load(std::memory_order_acquire) == 0) return false;
+            if (spin < kSpinLimit) std::this_thread::yield();
+            else sleep(not_empty_, [this] { return canPop() || producers_.load(std::memory_order_acquire) == 0; });
+        }
+    }
+
+    void producerDone() {
+        producers_.fetch_sub(1, std::memory_order_acq_rel);
+        notify(not_empty_);
+    }
+
+    // Aborts the pipeline: wakes every blocked thread; later push/pop calls return false
+    void close() {
+        closed_.store(true, std::memory_order_release);
+        { std::lock_guard<std::mutex> lock(mutex_); }
+        not_full_.notify_all();
+        not_empty_.notify_all();
+    }
+
+    size_t size() const {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t head = head_.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+    size_t capacity() const { return mask_ + 1; }
+
+private:
+    static constexpr int kSpinLimit = 64;
+
+    struct Cell {
+        std::atomic<size_t> seq;
+        T data;
+    };
+
+    bool canPush() const {
+        size_t pos = tail_.load(std::memory_order_relaxed);
+        return cells_[pos & mask_].seq.load(std::memory_order_acquire) >= pos;
+    }
+    bool canPop() const {
+        size_t pos = head_.load(std::memory_order_relaxed);
+        return cells_[pos & mask_].seq.load(std::memory_order_acquire) >= pos + 1;
+    }
+
+    // The seq_cst fences pair with the ones in notify(): either the sleeper sees the new state or the notifier sees the sleeper
+    template <typename Ready>
+    void sleep(std::condition_variable& cv, Ready ready) {
+        sleepers_.fetch_add(1, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv.wait(lock, [&] { return closed_.load(std::memory_order_acquire) || ready(); });
+        }
+        sleepers_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void notify(std::condition_variable& cv) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleepers_.load(std::memory_order_relaxed) == 0) return;   // fast path: nobody is asleep
+        { std::lock_guard<std::mutex> lock(mutex_); }
+        cv.notify_all();
+    }
+
+    std::unique_ptr<Cell[]> cells_;
+    size_t mask_ = 0;
+    alignas(64) std::atomic<size_t> head_{0};
+    alignas(64) std::atomic<size_t> tail_{0};
+    alignas(64) std::atomic<int> producers_;
+    std::atomic<int> sleepers_{0};
+    std::atomic<bool> closed_{false};
+    std::mutex mutex_;
+    std::condition_variable not_full_, not_empty_;
+};
+
+// ---------------- Pipeline data ----------------
+struct Frame {
+    size_t index = 0;
+    cv::Mat image;                 // decoded BGR frame (boxes are drawn onto it)
+    std::vector<float> tensor;     // CHW float input
+    Ort::Value output{nullptr};    // [1, 300, 6] model output
+};
+using FramePtr = std::unique_ptr<Frame>;
+using FrameQueue = BoundedQueue<FramePtr>;
+
+struct StageStats {
+    std::string name;
+    int threads = 1;
+    std::atomic<size_t> items{0};
+    std::atomic<int64_t> busy_ns{0};
+};
+
+struct QueueStats {
+    std::string name;
+    const FrameQueue* queue = nullptr;
+    size_t samples = 0, sum = 0, max = 0, full = 0;
+};
+
+// Runs `threads` workers of one stage; each worker signals its output queue when it exits.
+// An exception inside a worker is handed to `on_error` instead of escaping the thread (which would call std::terminate).
+void launchStage(std::vector<std::thread>& pool, StageStats& stats, FrameQueue* out,
+                 const std::function<void(StageStats&)>& body,
+                 const std::function<void(std::exception_ptr)>& on_error) {
+    for (int t = 0; t < stats.threads; t++) {
+        pool.emplace_back([&stats, out, body, &on_error] {
+            try {
+                body(stats);
+            } catch (...) {
+                on_error(std::current_exception());
+            }
+            if (out) out->producerDone();
+        });
+    }
+}
+
+// Consume from `in`, apply `fn`, forward to `out` (if any), while timing the busy part
+void runWorker(FrameQueue& in, FrameQueue* out, StageStats& stats, const std::function<void(Frame&)>& fn) {
+    FramePtr frame;
+    while (in.pop(frame)) {
+        auto t0 = Clock::now();
+        fn(*frame);
+        stats.busy_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t0).count();
+        stats.items++;
+        if (out) {
+            if (!out->push(std::move(frame))) break;   // pipeline aborted
+        } else {
+            frame.reset();
+        }
+    }
+}
+
+bool isImageFile(const fs::path& p) {
+    std::string ext = p.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+    return ext == ".jpg" || ext == ".jpeg" || ext == ".png" || ext == ".bmp";
+}
+
+// ---------------- Main ----------------
+int main(int argc, char** argv) {
+    try {
+        std::cout << "--- YOLOv10 Streaming Pipeline Demo ---" << std::endl;
+
+        const std::string input_path = argc > 1 ? argv[1] : "/assets/images";
+        const std::string output_dir = argc > 2 ? argv[2] : "/assets/output/pipeline";
+        int thread_counts[5] = {2, 2, 1, 1, 2};   // decode, preprocess, inference, postprocess, encode
+        for (int i = 0; i < 5 && 3 + i < argc; i++) thread_counts[i] = std::max(1, std::atoi(argv[3 + i]));
+        const size_t queue_capacity = argc > 8 ? std::max(2, std::atoi(argv[8])) : 16;
+
+        const int input_w = 640, input_h = 640;
+        const float conf_threshold = 0.25f;
+
+        // 1. Input source: directory of images or a video file
+        const bool is_dir = fs::is_directory(input_path);
+        std::vector<std::string> files;
+        cv::VideoCapture video;
+        if (is_dir) {
+            for (const auto& entry : fs::directory_iterator(input_path)) {
+                if (entry.is_regular_file() && isImageFile(entry.path())) files.push_back(entry.path().string());
+            }
+            std::sort(files.begin(), files.end());
+            if (files.empty()) {
+                std::cerr << " Error: no images found in " << input_path << std::endl;
+                return -1;
+            }
+        } else {
+            video = cv::VideoCapture(input_path);
+            if (!video.isOpened()) {
+                std::cerr << " Error: could not open video " << input_path << std::endl;
+                return -1;
+            }
+            thread_counts[0] = 1;   // VideoCapture must be read sequentially
+        }
+        fs::create_directories(output_dir);
+
+        // 2. One shared session; disable spinning so idle ORT workers do not steal cores from other stages
+        Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "YOLOv10Pipeline");
+        Ort::SessionOptions session_options;
+        session_options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+        session_options.AddConfigEntry("session.intra_op.allow_spinning", "0");
+
+        const std::string model_path = "/assets/models/yolov10n.onnx";
+        Ort::Session session(env, model_path.c_str(), session_options);
+
+        Ort::AllocatorWithDefaultOptions allocator;
+        auto input_name_alloc = session.GetInputNameAllocated(0, allocator);
+        auto output_name_alloc = session.GetOutputNameAllocated(0, allocator);
+        const char* input_names[] = {input_name_alloc.get()};
+        const char* output_names[] = {output_name_alloc.get()};
+        Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+
+        // 3. Stages and the queues between them
+        StageStats stages[5];
+        const char* stage_names[5] = {"decode", "preprocess", "inference", "postprocess", "encode"};
+        for (int i = 0; i < 5; i++) {
+            stages[i].name = stage_names[i];
+            stages[i].threads = thread_counts[i];
+        }
+
+        FrameQueue q_decoded(queue_capacity, stages[0].threads);
+        FrameQueue q_prepped(queue_capacity, stages[1].threads);
+        FrameQueue q_inferred(queue_capacity, stages[2].threads);
+        FrameQueue q_drawn(queue_capacity, stages[3].threads);
+
+        std::vector<QueueStats> queue_stats = {
+            {"decode->preprocess", &q_decoded}, {"preprocess->inference", &q_prepped},
+            {"inference->postprocess", &q_inferred}, {"postprocess->encode", &q_drawn}};
+
+        std::cout << "Input: " << input_path << (is_dir ? " (directory, " + std::to_string(files.size()) + " images)" : " (video)")
+                  << " | Output: " << output_dir << " | Queue capacity: " << q_decoded.capacity() << std::endl;
+        std::cout << "Threads: decode " << stages[0].threads << ", preprocess " << stages[1].threads
+                  << ", inference " << stages[2].threads << ", postprocess " << stages[3].threads
+                  << ", encode " << stages[4].threads << std::endl;
+
+        std::atomic<size_t> next_file{0};
+        std::atomic<bool> running{true};
+        std::vector<std::thread> pool;
+
+        // First exception from any stage; closing the queues makes every other stage return
+        std::exception_ptr stage_error;
+        std::mutex error_mutex;
+        std::function<void(std::exception_ptr)> on_error = [&](std::exception_ptr e) {
+            {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if (!stage_error) stage_error = e;
+            }
+            for (FrameQueue* q : {&q_decoded, &q_prepped, &q_inferred, &q_drawn}) q->close();
+        };
+        auto wall_start = Clock::now();
+
+        // decode
+        launchStage(pool, stages[0], &q_decoded, [&](StageStats& st) {
+            for (;;) {
+                auto t0 = Clock::now();
+                auto frame = std::make_unique<Frame>();
+                if (is_dir) {
+                    size_t i = next_file.fetch_add(1);
+                    if (i >= files.size()) break;
+                    frame->index = i;
+                    frame->image = cv::imread(files[i]);
+                    if (frame->image.empty()) {
+                        std::cerr << " Warning: could not decode " << files[i] << std::endl;
+                        continue;
+                    }
+                } else {
+                    if (!video.read(frame->image)) break;
+                    frame->index = next_file.fetch_add(1);
+                }
+                st.busy_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t0).count();
+                st.items++;
+                if (!q_decoded.push(std::move(frame))) break;
+            }
+        }, on_error);
+
+        // preprocess
+        launchStage(pool, stages[1], &q_prepped, [&](StageStats& st) {
+            runWorker(q_decoded, &q_prepped, st, [&](Frame& f) {
+                cv::Mat resized;
+                cv::resize(f.image, resized, cv::Size(input_w, input_h));
+                resized.convertTo(resized, CV_32F, 1.0 / 255.0);
+
+                const size_t plane = static_cast<size_t>(input_w) * input_h;
+                f.tensor.resize(3 * plane);
+                std::vector<cv::Mat> channels = {
+                    cv::Mat(input_h, input_w, CV_32F, f.tensor.data()),
+                    cv::Mat(input_h, input_w, CV_32F, f.tensor.data() + plane),
+                    cv::Mat(input_h, input_w, CV_32F, f.tensor.data() + 2 * plane)};
+                cv::split(resized, channels);
+            });
+        }, on_error);
+
+        // inference
+        launchStage(pool, stages[2], &q_inferred, [&](StageStats& st) {
+            const std::vector<int64_t> input_shape = {1, 3, input_h, input_w};
+            runWorker(q_prepped, &q_inferred, st, [&](Frame& f) {
+                Ort::Value input_tensor = Ort::Value::CreateTensor<float>(
+                    memory_info, f.tensor.data(), f.tensor.size(), input_shape.data(), input_shape.size());
+                auto outputs = session.Run(Ort::RunOptions{nullptr}, input_names, &input_tensor, 1, output_names, 1);
+                f.output = std::move(outputs[0]);
+                f.tensor = std::vector<float>();   // release the input buffer early
+            });
+        }, on_error);
+
+        // postprocess
+        launchStage(pool, stages[3], &q_drawn, [&](StageStats& st) {
+            runWorker(q_inferred, &q_drawn, st, [&](Frame& f) {
+                const float* data = f.output.GetTensorData<float>();
+                auto shape = f.output.GetTensorTypeAndShapeInfo().GetShape();
+                const float sx = static_cast<float>(f.image.cols) / input_w;
+                const float sy = static_cast<float>(f.image.rows) / input_h;
+
+                for (int64_t i = 0; i < shape[1]; i++) {
+                    const float* d = data + i * shape[2];
+                    if (d[4] < conf_threshold) continue;
+                    cv::Rect box((int)(d[0] * sx), (int)(d[1] * sy),
+                                 (int)((d[2] - d[0]) * sx), (int)((d[3] - d[1]) * sy));
+                    cv::rectangle(f.image, box, cv::Scalar(0, 255, 0), 2);
+                    cv::putText(f.image,
+                                "cls " + std::to_string((int)d[5]) + ":" + cv::format("%.2f", d[4]),
+                                cv::Point(box.x, box.y - 5),
+                                cv::FONT_HERSHEY_SIMPLEX, 0.5,
+                                cv::Scalar(255, 0, 0), 1);
+                }
+                f.output = Ort::Value{nullptr};
+            });
+        }, on_error);
+
+        // encode
+        launchStage(pool, stages[4], nullptr, [&](StageStats& st) {
+            runWorker(q_drawn, nullptr, st, [&](Frame& f) {
+                cv::imwrite(output_dir + "/" + cv::format("frame_%06zu.jpg", f.index), f.image);
+            });
+        }, on_error);
+
+        // 4. Sample queue occupancy while the pipeline runs
+        std::thread monitor([&] {
+            while (running.load()) {
+                for (auto& q : queue_stats) {
+                    size_t n = q.queue->size();
+                    q.samples++;
+                    q.sum += n;
+                    q.max = std::max(q.max, n);
+                    if (n >= q.queue->capacity()) q.full++;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+        });
+
+        for (auto& t : pool) t.join();
+        running = false;
+        monitor.join();
+        if (stage_error) std::rethrow_exception(stage_error);
+        double wall_s = std::chrono::duration<double>(Clock::now() - wall_start).count();
+
+        // 5. Report
+        std::cout << "\nFrames: " << stages[4].items << " in " << cv::format("%.2f", wall_s) << " s ("
+                  << cv::format("%.1f", stages[4].items / wall_s) << " FPS end-to-end)" << std::endl;
+
+        std::cout << "\nStage        | threads | items | items/s | avg ms/item | utilization" << std::endl;
+        int bottleneck = 0;
+        double worst_util = 0.0;
+        for (int i = 0; i < 5; i++) {
+            const StageStats& s = stages[i];
+            double busy_s = s.busy_ns.load() / 1e9;
+            double util = busy_s / (wall_s * s.threads);
+            if (util > worst_util) {
+                worst_util = util;
+                bottleneck = i;
+            }
+            std::cout << cv::format("%-12s | %7d | %5zu | %7.1f | %11.2f | %10.1f%%",
+                                    s.name.c_str(), s.threads, s.items.load(), s.items / wall_s,
+                                    s.items ? busy_s * 1000.0 / s.items : 0.0, util * 100.0)
+                      << std::endl;
+        }
+
+        std::cout << "\nQueue                  | avg occupancy | max | time full" << std::endl;
+        for (const auto& q : queue_stats) {
+            double avg = q.samples ? static_cast<double>(q.sum) / q.samples : 0.0;
+            double full_pct = q.samples ? 100.0 * q.full / q.samples : 0.0;
+            std::cout << cv::format("%-22s | %8.1f / %-3zu | %3zu | %8.1f%%",
+                                    q.name.c_str(), avg, q.queue->capacity(), q.max, full_pct)
+                      << std::endl;
+        }
+
+        std::cout << "\nBottleneck: " << stages[bottleneck].name << " ("
+                  << cv::format("%.1f", worst_util * 100.0) << "% busy). Give it more threads first." << std::endl;
+    }
+    catch (const Ort::Exception& e) {
+        std::cerr << "ONNX Runtime error: " << e.what() << std::endl;
+        return -1;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Standard exception: " << e.what() << std::endl;
+        return -1;
+    }
+
+    return 0;
+}
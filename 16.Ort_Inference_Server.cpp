@@ -0,0 +1,222 @@
+/*
+
+Why do we need an inference server component?
+----------------------------------------------------
+08.Ort_Session_Run.cpp runs one Ort::Session on one thread with SetIntraOpNumThreads(1). Production traffic looks different: many
+small requests arrive at the same time from many threads. Calling Run from every client thread directly gives no control over
+how many inferences run at once, so the CPU gets oversubscribed.
+
+InferenceServer owns a fixed set of worker threads and a request queue:
+
+    client threads --submit(input)--> [request queue] --> worker 0 --Run--> session
+                   <--std::future----                 --> worker 1 --Run--> session (shared) or its own session (pool)
+                                                      --> ...
+
+    - One Ort::Env is shared by everything (one logging/threading runtime per process, see 02.Ort_Env.cpp).
+    - "shared" mode: all workers call Run on ONE session. Ort::Session::Run is thread-safe, and the weights are loaded once.
+    - "pool" mode  : every worker has its own session. The cost is more memory, but sessions share no internal state
+                     (arena, execution plan), which can help tail latency.
+    - Each session uses 1 intra-op thread, so the number of workers is the level of parallelism and the cores are not
+      oversubscribed.
+
+The built-in load generator runs a closed loop: C client threads each submit a request, wait for its future, and repeat. It
+measures QPS and p50/p99 latency as client concurrency grows from 1 to 64.
+
+Usage:
+    ./ort_inference_server [shared|pool] [workers] [seconds per step]
+
+*/
+
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <onnxruntime_cxx_api.h>
+
+using Clock = std::chrono::steady_clock;
+
+class InferenceServer {
+public:
+    InferenceServer(Ort::Env& env, const char* model_path, bool pooled, int workers) {
+        Ort::SessionOptions session_options;
+        session_options.SetIntraOpNumThreads(1);
+        session_options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+
+        const int num_sessions = pooled ? workers : 1;
+        for (int i = 0; i < num_sessions; i++) {
+            sessions_.emplace_back(env, model_path, session_options);
+        }
+
+        // Names and shapes are the same for every session, cache them once
+        Ort::AllocatorWithDefaultOptions allocator;
+        input_name_ = sessions_[0].GetInputNameAllocated(0, allocator).get();
+        output_name_ = sessions_[0].GetOutputNameAllocated(0, allocator).get();
+        input_shape_ = sessions_[0].GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+        if (!input_shape_.empty() && input_shape_[0] < 0) input_shape_[0] = 1;
+        input_size_ = 1;
+        for (int64_t d : input_shape_) input_size_ *= static_cast<size_t>(d);
+
+        for (int i = 0; i < workers; i++) {
+            workers_.emplace_back([this, i, pooled] { workerLoop(sessions_[pooled ? i : 0]); });
+        }
+    }
+
+    ~InferenceServer() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        for (auto& w : workers_) w.join();
+    }
+
+    // Thread-safe: any client thread may call this
+    std::future<std::vector<float>> submit(std::vector<float> input) {
+        Request request{std::move(input), {}};
+        auto future = request.result.get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.push_back(std::move(request));
+        }
+        cv_.notify_one();
+        return future;
+    }
+
+    size_t inputSize() const { return input_size_; }
+    size_t sessionCount() const { return sessions_.size(); }
+
+private:
+    struct Request {
+        std::vector<float> input;
+        std::promise<std::vector<float>> result;
+    };
+
+    void workerLoop(Ort::Session& session) {
+        Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+        const char* input_names[] = {input_name_.c_str()};
+        const char* output_names[] = {output_name_.c_str()};
+
+        for (;;) {
+            Request request;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+                if (queue_.empty()) return;   // stopping and drained
+                request = std::move(queue_.front());
+                queue_.pop_front();
+            }
+
+            try {
+                Ort::Value input_tensor = Ort::Value::CreateTensor<float>(
+                    memory_info, request.input.data(), request.input.size(),
+                    input_shape_.data(), input_shape_.size());
+                auto outputs = session.Run(Ort::RunOptions{nullptr},
+                                           input_names, &input_tensor, 1,
+                                           output_names, 1);
+                const float* out = outputs[0].GetTensorData<float>();
+                size_t n = outputs[0].GetTensorTypeAndShapeInfo().GetElementCount();
+                request.result.set_value(std::vector<float>(out, out + n));
+            } catch (...) {
+                request.result.set_exception(std::current_exception());
+            }
+        }
+    }
+
+    std::vector<Ort::Session> sessions_;
+    std::vector<std::thread> workers_;
+    std::string input_name_, output_name_;
+    std::vector<int64_t> input_shape_;
+    size_t input_size_ = 0;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<Request> queue_;
+    bool stopping_ = false;
+};
+
+double percentile(std::vector<double>& v, double p) {
+    if (v.empty()) return 0.0;
+    size_t k = static_cast<size_t>(p * (v.size() - 1));
+    std::nth_element(v.begin(), v.begin() + k, v.end());
+    return v[k];
+}
+
+// ---------------- Main ----------------
+int main(int argc, char** argv) {
+    std::cout << "--- Concurrent Inference Server Demo ---" << std::endl;
+
+    const bool pooled = !(argc > 1 && std::strcmp(argv[1], "shared") == 0);
+    const int hw = std::max(1u, std::thread::hardware_concurrency());
+    const int workers = argc > 2 ? std::max(1, std::atoi(argv[2])) : hw;
+    const double seconds = argc > 3 ? std::atof(argv[3]) : 2.0;
+    const char* model_path = "/assets/models/mnist.onnx";
+
+    try {
+        Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "InferenceServer");
+        InferenceServer server(env, model_path, pooled, workers);
+
+        std::cout << "Mode: " << (pooled ? "pool" : "shared") << " | Workers: " << workers
+                  << " | Sessions: " << server.sessionCount() << " | Step: " << seconds << " s" << std::endl;
+
+        // Sanity check: one request end-to-end
+        std::vector<float> digit(server.inputSize(), 0.0f);
+        digit[0] = 1.0f;
+        auto probs = server.submit(digit).get();
+        std::cout << "Single request -> predicted digit "
+                  << std::distance(probs.begin(), std::max_element(probs.begin(), probs.end())) << std::endl;
+
+        // Closed-loop load generator
+        std::cout << "\nclients |      QPS | p50 (ms) | p99 (ms)" << std::endl;
+        for (int clients : {1, 2, 4, 8, 16, 32, 64}) {
+            std::atomic<bool> stop{false};
+            std::vector<std::vector<double>> latencies(clients);
+            std::vector<std::thread> threads;
+
+            auto t0 = Clock::now();
+            for (int c = 0; c < clients; c++) {
+                threads.emplace_back([&, c] {
+                    std::vector<float> input(server.inputSize());
+                    for (size_t i = 0; i < input.size(); i++) input[i] = static_cast<float>((i * 7 + c) % 255) / 255.0f;
+                    while (!stop.load(std::memory_order_relaxed)) {
+                        auto s = Clock::now();
+                        server.submit(input).get();
+                        latencies[c].push_back(std::chrono::duration<double, std::milli>(Clock::now() - s).count());
+                    }
+                });
+            }
+            std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+            stop = true;
+            for (auto& t : threads) t.join();
+            double elapsed = std::chrono::duration<double>(Clock::now() - t0).count();
+
+            std::vector<double> all;
+            for (auto& l : latencies) all.insert(all.end(), l.begin(), l.end());
+            double qps = all.size() / elapsed;
+            double p50 = percentile(all, 0.50);
+            double p99 = percentile(all, 0.99);
+            std::printf("%7d | %8.0f | %8.3f | %8.3f\n", clients, qps, p50, p99);
+        }
+    }
+    catch (const Ort::Exception& e) {
+        std::cerr << "ONNX Runtime error: " << e.what() << std::endl;
+        return -1;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Standard exception: " << e.what() << std::endl;
+        return -1;
+    }
+
+    std::cout << "--- Demo Complete ---" << std::endl;
+    return 0;
+}
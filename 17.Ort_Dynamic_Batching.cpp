@@ -0,0 +1,318 @@
+/*
+
+Why do we need dynamic micro-batching?
+----------------------------------------------------
+08.Ort_Session_Run.cpp runs a single [1, 1, 28, 28] sample per session.Run. For a model this small, most of each Run call is
+fixed overhead (input checks, execution frame setup, thread pool dispatch), not math. When many clients send single samples at
+the same time, it is much cheaper to combine them into one [N, 1, 28, 28] Run.
+
+DynamicBatcher collects incoming requests and dispatches a batch when EITHER:
+
+    - the batch reaches max_batch_size, or
+    - the oldest waiting request has waited max_wait,
+
+whichever happens first. The dispatcher then runs ONE batched session.Run, slices the [N, ...] output by row, and completes each
+caller's std::future with its own row. max_batch_size bounds the Run cost, and max_wait bounds the latency that batching can add.
+
+The stats show the distribution of batch sizes the dispatcher achieved and the queueing delay it added (time from submit to
+dispatch). The demo sweeps a few configurations under the same client load, and max_batch_size = 1 is the "no batching"
+baseline.
+
+NOTE: batching needs a model with a dynamic batch dimension. The bundled CNTK mnist.onnx is exported with a fixed batch of 1
+      (and a hard-coded Reshape), so for it the dispatcher falls back to one Run per request inside each batch. Batch formation
+      and queueing stats still work, but Run overhead is not amortized. Pass a dynamic-batch model path to see the full effect.
+
+Usage:
+    ./ort_dynamic_batching [model.onnx] [clients] [seconds per config]
+
+*/
+
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+#include <exception>
+#include <cstdlib>
+#include <cstdio>
+#include <onnxruntime_cxx_api.h>
+
+using Clock = std::chrono::steady_clock;
+
+struct BatchingConfig {
+    size_t max_batch_size = 16;
+    std::chrono::microseconds max_wait{1000};
+};
+
+struct BatchingStats {
+    std::map<size_t, size_t> batch_size_histogram;   // batch size -> number of batches
+    std::vector<double> queue_delay_ms;              // per request: submit -> dispatch
+    size_t batches = 0;
+    size_t requests = 0;
+};
+
+class DynamicBatcher {
+public:
+    DynamicBatcher(Ort::Session& session, BatchingConfig config)
+        : session_(session), config_(config),
+          memory_info_(Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault)) {
+        Ort::AllocatorWithDefaultOptions allocator;
+        input_name_ = session.GetInputNameAllocated(0, allocator).get();
+        output_name_ = session.GetOutputNameAllocated(0, allocator).get();
+
+        // Per-sample shape = model input shape without the batch dimension
+        std::vector<int64_t> shape = session.GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+        dynamic_batch_ = !shape.empty() && shape[0] < 0;
+        sample_shape_.assign(shape.begin() + 1, shape.end());
+        sample_size_ = 1;
+        for (int64_t d : sample_shape_) sample_size_ *= static_cast<size_t>(d);
+
+        dispatcher_ = std::thread([this] { dispatchLoop(); });
+    }
+
+    ~DynamicBatcher() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        dispatcher_.join();
+    }
+
+    // A sample of the wrong size would overflow (or leave stale data in) the shared batch tensor, so it never joins a batch:
+    // the returned future already holds std::invalid_argument
+    std::future<std::vector<float>> submit(std::vector<float> sample) {
+        if (sample.size() != sample_size_) {
+            std::promise<std::vector<float>> rejected;
+            rejected.set_exception(std::make_exception_ptr(std::invalid_argument(
+                "sample has " + std::to_string(sample.size()) + " floats, expected " + std::to_string(sample_size_))));
+            return rejected.get_future();
+        }
+        Request request{std::move(sample), {}, Clock::now()};
+        auto future = request.result.get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.push_back(std::move(request));
+        }
+        cv_.notify_one();
+        return future;
+    }
+
+    BatchingStats stats() {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        return stats_;
+    }
+
+    size_t sampleSize() const { return sample_size_; }
+    bool dynamicBatch() const { return dynamic_batch_; }
+
+private:
+    struct Request {
+        std::vector<float> input;
+        std::promise<std::vector<float>> result;
+        Clock::time_point enqueued;
+    };
+
+    void dispatchLoop() {
+        std::vector<Request> batch;
+        std::vector<float> batch_input;
+
+        for (;;) {
+            batch.clear();
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+                if (queue_.empty()) return;   // stopping and drained
+
+                // Wait until the batch is full or the oldest request hits its deadline
+                const auto deadline = queue_.front().enqueued + config_.max_wait;
+                cv_.wait_until(lock, deadline, [this] {
+                    return stopping_ || queue_.size() >= config_.max_batch_size;
+                });
+
+                const size_t n = std::min(queue_.size(), config_.max_batch_size);
+                for (size_t i = 0; i < n; i++) {
+                    batch.push_back(std::move(queue_.front()));
+                    queue_.pop_front();
+                }
+            }
+
+            const auto dispatched = Clock::now();
+            size_t completed = 0;   // promises [0, completed) are already satisfied and must not be set again
+            try {
+                if (dynamic_batch_) runBatched(batch, batch_input, completed);
+                else runUnbatched(batch, completed);
+            } catch (...) {
+                for (size_t i = completed; i < batch.size(); i++) batch[i].result.set_exception(std::current_exception());
+            }
+
+            std::lock_guard<std::mutex> lock(stats_mutex_);
+            stats_.batches++;
+            stats_.requests += batch.size();
+            stats_.batch_size_histogram[batch.size()]++;
+            for (const auto& r : batch) {
+                stats_.queue_delay_ms.push_back(std::chrono::duration<double, std::milli>(dispatched - r.enqueued).count());
+            }
+        }
+    }
+
+    // One Run for the whole batch, then hand each caller its own output row
+    void runBatched(std::vector<Request>& batch, std::vector<float>& batch_input, size_t& completed) {
+        const size_t n = batch.size();
+        batch_input.resize(n * sample_size_);
+        for (size_t i = 0; i < n; i++) {
+            std::copy(batch[i].input.begin(), batch[i].input.end(), batch_input.begin() + i * sample_size_);
+        }
+
+        std::vector<int64_t> shape = {static_cast<int64_t>(n)};
+        shape.insert(shape.end(), sample_shape_.begin(), sample_shape_.end());
+        Ort::Value input_tensor = Ort::Value::CreateTensor<float>(
+            memory_info_, batch_input.data(), batch_input.size(), shape.data(), shape.size());
+
+        const char* input_names[] = {input_name_.c_str()};
+        const char* output_names[] = {output_name_.c_str()};
+        auto outputs = session_.Run(Ort::RunOptions{nullptr}, input_names, &input_tensor, 1, output_names, 1);
+
+        const float* out = outputs[0].GetTensorData<float>();
+        const size_t row = outputs[0].GetTensorTypeAndShapeInfo().GetElementCount() / n;
+        for (size_t i = 0; i < n; i++) {
+            batch[i].result.set_value(std::vector<float>(out + i * row, out + (i + 1) * row));
+            completed = i + 1;
+        }
+    }
+
+    // Fixed-batch models: same batch formation, one Run per request
+    void runUnbatched(std::vector<Request>& batch, size_t& completed) {
+        std::vector<int64_t> shape = {1};
+        shape.insert(shape.end(), sample_shape_.begin(), sample_shape_.end());
+        const char* input_names[] = {input_name_.c_str()};
+        const char* output_names[] = {output_name_.c_str()};
+
+        for (Request& r : batch) {
+            Ort::Value input_tensor = Ort::Value::CreateTensor<float>(
+                memory_info_, r.input.data(), r.input.size(), shape.data(), shape.size());
+            auto outputs = session_.Run(Ort::RunOptions{nullptr}, input_names, &input_tensor, 1, output_names, 1);
+            const float* out = outputs[0].GetTensorData<float>();
+            r.result.set_value(std::vector<float>(out, out + outputs[0].GetTensorTypeAndShapeInfo().GetElementCount()));
+            completed++;
+        }
+    }
+
+    Ort::Session& session_;
+    BatchingConfig config_;
+    Ort::MemoryInfo memory_info_;
+    std::string input_name_, output_name_;
+    std::vector<int64_t> sample_shape_;
+    size_t sample_size_ = 0;
+    bool dynamic_batch_ = false;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<Request> queue_;
+    bool stopping_ = false;
+    std::thread dispatcher_;
+
+    std::mutex stats_mutex_;
+    BatchingStats stats_;
+};
+
+double percentile(std::vector<double> v, double p) {
+    if (v.empty()) return 0.0;
+    size_t k = static_cast<size_t>(p * (v.size() - 1));
+    std::nth_element(v.begin(), v.begin() + k, v.end());
+    return v[k];
+}
+
+// ---------------- Main ----------------
+int main(int argc, char** argv) {
+    std::cout << "--- Dynamic Micro-Batching Demo ---" << std::endl;
+
+    const char* model_path = argc > 1 ? argv[1] : "/assets/models/mnist.onnx";
+    const int clients = argc > 2 ? std::max(1, std::atoi(argv[2])) : 32;
+    const double seconds = argc > 3 ? std::atof(argv[3]) : 2.0;
+
+    try {
+        Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "DynamicBatching");
+        Ort::SessionOptions session_options;
+        session_options.SetIntraOpNumThreads(std::max(1u, std::thread::hardware_concurrency()));
+        session_options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+        Ort::Session session(env, model_path, session_options);
+
+        std::cout << "Model: " << model_path << " | Clients: " << clients << " | " << seconds << " s per config" << std::endl;
+
+        // max_batch_size = 1 is the unbatched baseline
+        const std::vector<BatchingConfig> configs = {
+            {1, std::chrono::microseconds(0)},
+            {8, std::chrono::microseconds(500)},
+            {16, std::chrono::microseconds(1000)},
+            {32, std::chrono::microseconds(2000)},
+        };
+
+        std::cout << "\nmax_batch | max_wait us |    QPS | p50 ms | p99 ms | avg batch | avg queue ms | p99 queue ms" << std::endl;
+        for (const auto& config : configs) {
+            DynamicBatcher batcher(session, config);
+            if (&config == &configs.front() && !batcher.dynamicBatch()) {
+                std::cout << "(model has a fixed batch dimension: batches are formed but run one sample at a time)" << std::endl;
+            }
+
+            std::atomic<bool> stop{false};
+            std::vector<std::vector<double>> latencies(clients);
+            std::vector<std::thread> threads;
+
+            auto t0 = Clock::now();
+            for (int c = 0; c < clients; c++) {
+                threads.emplace_back([&, c] {
+                    std::vector<float> sample(batcher.sampleSize());
+                    for (size_t i = 0; i < sample.size(); i++) sample[i] = static_cast<float>((i + c) % 255) / 255.0f;
+                    while (!stop.load(std::memory_order_relaxed)) {
+                        auto s = Clock::now();
+                        batcher.submit(sample).get();
+                        latencies[c].push_back(std::chrono::duration<double, std::milli>(Clock::now() - s).count());
+                    }
+                });
+            }
+            std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+            stop = true;
+            for (auto& t : threads) t.join();
+            double elapsed = std::chrono::duration<double>(Clock::now() - t0).count();
+
+            std::vector<double> all;
+            for (auto& l : latencies) all.insert(all.end(), l.begin(), l.end());
+            BatchingStats stats = batcher.stats();
+
+            double avg_queue = 0.0;
+            for (double d : stats.queue_delay_ms) avg_queue += d;
+            if (!stats.queue_delay_ms.empty()) avg_queue /= stats.queue_delay_ms.size();
+
+            std::printf("%9zu | %11lld | %6.0f | %6.3f | %6.3f | %9.2f | %12.3f | %12.3f\n",
+                        config.max_batch_size, static_cast<long long>(config.max_wait.count()),
+                        all.size() / elapsed, percentile(all, 0.50), percentile(all, 0.99),
+                        stats.batches ? static_cast<double>(stats.requests) / stats.batches : 0.0,
+                        avg_queue, percentile(stats.queue_delay_ms, 0.99));
+
+            std::cout << "          batch sizes:";
+            for (const auto& [size, count] : stats.batch_size_histogram) std::cout << " " << size << "x" << count;
+            std::cout << std::endl;
+        }
+    }
+    catch (const Ort::Exception& e) {
+        std::cerr << "ONNX Runtime error: " << e.what() << std::endl;
+        return -1;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Standard exception: " << e.what() << std::endl;
+        return -1;
+    }
+
+    std::cout << "--- Demo Complete ---" << std::endl;
+    return 0;
+}
@@ -0,0 +1,292 @@
+/*
+
+Why do we need a SessionOptions auto-tuner?
+----------------------------------------------------
+03.Ort_SessionOptions.cpp, 05.Ort_Session.cpp, 08.Ort_Session_Run.cpp and 09.Ort_ModelOptimization.cpp each hard-code a different
+choice:
+
+    - intra-op threads    : 1 or 2
+    - optimization level  : BASIC, EXTENDED or ALL
+    - DisableMemPattern / EnableCpuMemArena
+
+None of these choices was ever measured. The best values depend on the model, the input shape, the CPU and what we optimize for:
+
+    - p99 latency : one request at a time; more intra-op threads usually help until synchronization costs dominate.
+    - throughput  : many requests at once; fewer intra-op threads per Run plus several concurrent callers often win.
+
+This tool sweeps intra-op threads, inter-op threads, ExecutionMode (sequential / parallel), graph optimization level, memory pattern
+and CPU arena against a given model and input shape. It benchmarks every combination and writes the winner for the chosen metric
+to a plain key=value config file. At startup the runtime calls loadTunedSessionOptions() on that file, as shown at the end of main.
+
+Usage:
+    ./ort_session_tuner [model.onnx] [p99|throughput] [input shape, e.g. 1,1,28,28] [config out] [runs per config]
+
+Config file example:
+    # tuned for /assets/models/mnist.onnx, metric p99
+    intra_op_threads=2
+    inter_op_threads=1
+    execution_mode=SEQUENTIAL
+    graph_optimization_level=ALL
+    mem_pattern=1
+    cpu_mem_arena=1
+
+*/
+
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <cstdlib>
+#include <cstdio>
+#include <onnxruntime_cxx_api.h>
+
+using Clock = std::chrono::steady_clock;
+
+struct TunedOptions {
+    int intra_op_threads = 1;
+    int inter_op_threads = 1;
+    ExecutionMode execution_mode = ExecutionMode::ORT_SEQUENTIAL;
+    GraphOptimizationLevel optimization_level = GraphOptimizationLevel::ORT_ENABLE_ALL;
+    bool mem_pattern = true;
+    bool cpu_mem_arena = true;
+};
+
+const char* levelName(GraphOptimizationLevel level) {
+    switch (level) {
+        case GraphOptimizationLevel::ORT_DISABLE_ALL:     return "DISABLE";
+        case GraphOptimizationLevel::ORT_ENABLE_BASIC:    return "BASIC";
+        case GraphOptimizationLevel::ORT_ENABLE_EXTENDED: return "EXTENDED";
+        default:                                          return "ALL";
+    }
+}
+
+GraphOptimizationLevel levelFromName(const std::string& name) {
+    if (name == "DISABLE") return GraphOptimizationLevel::ORT_DISABLE_ALL;
+    if (name == "BASIC") return GraphOptimizationLevel::ORT_ENABLE_BASIC;
+    if (name == "EXTENDED") return GraphOptimizationLevel::ORT_ENABLE_EXTENDED;
+    return GraphOptimizationLevel::ORT_ENABLE_ALL;
+}
+
+std::string describe(const TunedOptions& o) {
+    return "intra=" + std::to_string(o.intra_op_threads) +
+           " inter=" + std::to_string(o.inter_op_threads) +
+           " mode=" + (o.execution_mode == ExecutionMode::ORT_PARALLEL ? "PAR" : "SEQ") +
+           " opt=" + levelName(o.optimization_level) +
+           " mempat=" + (o.mem_pattern ? "1" : "0") +
+           " arena=" + (o.cpu_mem_arena ? "1" : "0");
+}
+
+void applyOptions(const TunedOptions& o, Ort::SessionOptions& session_options) {
+    session_options.SetIntraOpNumThreads(o.intra_op_threads);
+    session_options.SetInterOpNumThreads(o.inter_op_threads);
+    session_options.SetExecutionMode(o.execution_mode);
+    session_options.SetGraphOptimizationLevel(o.optimization_level);
+    if (o.mem_pattern) session_options.EnableMemPattern();
+    else session_options.DisableMemPattern();
+    if (o.cpu_mem_arena) session_options.EnableCpuMemArena();
+    else session_options.DisableCpuMemArena();
+}
+
+void saveTunedOptions(const std::string& path, const TunedOptions& o, const std::string& header) {
+    std::ofstream out(path);
+    if (!out) throw std::runtime_error("cannot write config file " + path);
+    out << "# " << header << "\n";
+    out << "intra_op_threads=" << o.intra_op_threads << "\n";
+    out << "inter_op_threads=" << o.inter_op_threads << "\n";
+    out << "execution_mode=" << (o.execution_mode == ExecutionMode::ORT_PARALLEL ? "PARALLEL" : "SEQUENTIAL") << "\n";
+    out << "graph_optimization_level=" << levelName(o.optimization_level) << "\n";
+    out << "mem_pattern=" << (o.mem_pattern ? 1 : 0) << "\n";
+    out << "cpu_mem_arena=" << (o.cpu_mem_arena ? 1 : 0) << "\n";
+}
+
+// Runtime side: read the tuned config at startup and apply it. Missing keys keep their defaults.
+bool loadTunedSessionOptions(const std::string& path, Ort::SessionOptions& session_options, TunedOptions* loaded = nullptr) {
+    std::ifstream in(path);
+    if (!in) return false;
+
+    TunedOptions o;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        auto eq = line.find('=');
+        if (eq == std::string::npos) continue;
+        std::string key = line.substr(0, eq), value = line.substr(eq + 1);
+
+        if (key == "intra_op_threads") o.intra_op_threads = std::atoi(value.c_str());
+        else if (key == "inter_op_threads") o.inter_op_threads = std::atoi(value.c_str());
+        else if (key == "execution_mode") o.execution_mode = value == "PARALLEL" ? ExecutionMode::ORT_PARALLEL : ExecutionMode::ORT_SEQUENTIAL;
+        else if (key == "graph_optimization_level") o.optimization_level = levelFromName(value);
+        else if (key == "mem_pattern") o.mem_pattern = value == "1";
+        else if (key == "cpu_mem_arena") o.cpu_mem_arena = value == "1";
+    }
+    applyOptions(o, session_options);
+    if (loaded) *loaded = o;
+    return true;
+}
+
+std::vector<int64_t> parseShape(const std::string& text) {
+    std::vector<int64_t> shape;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) shape.push_back(std::atoll(item.c_str()));
+    return shape;
+}
+
+struct Measurement {
+    double p50_ms = 0, p99_ms = 0, throughput = 0;
+};
+
+// Latency: one caller, sequential runs. Throughput: enough callers to fill the cores at this intra-op setting.
+Measurement benchmark(Ort::Env& env, const char* model_path, const TunedOptions& o,
+                      const std::vector<int64_t>& shape, int runs, bool measure_throughput) {
+    Ort::SessionOptions session_options;
+    applyOptions(o, session_options);
+    Ort::Session session(env, model_path, session_options);
+
+    Ort::AllocatorWithDefaultOptions allocator;
+    auto input_name = session.GetInputNameAllocated(0, allocator);
+    auto output_name = session.GetOutputNameAllocated(0, allocator);
+    const char* input_names[] = {input_name.get()};
+    const char* output_names[] = {output_name.get()};
+
+    size_t count = 1;
+    for (int64_t d : shape) count *= static_cast<size_t>(d);
+    Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+
+    auto worker = [&](int n, std::vector<double>* latencies) {
+        std::vector<float> data(count);
+        for (size_t i = 0; i < count; i++) data[i] = static_cast<float>(i % 255) / 255.0f;
+        Ort::Value input = Ort::Value::CreateTensor<float>(memory_info, data.data(), data.size(), shape.data(), shape.size());
+        for (int i = 0; i < n; i++) {
+            auto t0 = Clock::now();
+            session.Run(Ort::RunOptions{nullptr}, input_names, &input, 1, output_names, 1);
+            if (latencies) latencies->push_back(std::chrono::duration<double, std::milli>(Clock::now() - t0).count());
+        }
+    };
+
+    worker(5, nullptr);   // warm-up
+
+    Measurement m;
+    if (!measure_throughput) {
+        std::vector<double> lat;
+        worker(runs, &lat);
+        std::sort(lat.begin(), lat.end());
+        m.p50_ms = lat[lat.size() / 2];
+        m.p99_ms = lat[static_cast<size_t>(0.99 * (lat.size() - 1))];
+        m.throughput = 1000.0 * runs / std::max(1e-9, std::accumulate(lat.begin(), lat.end(), 0.0));
+    } else {
+        const int hw = std::max(1u, std::thread::hardware_concurrency());
+        const int callers = std::max(1, hw / std::max(1, o.intra_op_threads));
+        std::vector<std::vector<double>> lat(callers);
+        std::vector<std::thread> threads;
+        auto t0 = Clock::now();
+        for (int c = 0; c < callers; c++) threads.emplace_back(worker, runs, &lat[c]);
+        for (auto& t : threads) t.join();
+        double elapsed = std::chrono::duration<double>(Clock::now() - t0).count();
+
+        std::vector<double> all;
+        for (auto& l : lat) all.insert(all.end(), l.begin(), l.end());
+        std::sort(all.begin(), all.end());
+        m.p50_ms = all[all.size() / 2];
+        m.p99_ms = all[static_cast<size_t>(0.99 * (all.size() - 1))];
+        m.throughput = all.size() / elapsed;
+    }
+    return m;
+}
+
+// ---------------- Main ----------------
+int main(int argc, char** argv) {
+    std::cout << "--- SessionOptions Auto-Tuner ---" << std::endl;
+
+    const char* model_path = argc > 1 ? argv[1] : "/assets/models/mnist.onnx";
+    const std::string metric = argc > 2 ? argv[2] : "p99";
+    const bool throughput_metric = metric == "throughput";
+    const std::string config_path = argc > 4 ? argv[4] : "session_options.tuned";
+    const int runs = argc > 5 ? std::max(10, std::atoi(argv[5])) : 200;
+
+    try {
+        Ort::Env env(ORT_LOGGING_LEVEL_ERROR, "SessionOptionsTuner");
+
+        // 1. Input shape: from the command line, or from the model (dynamic dims -> 1)
+        std::vector<int64_t> shape;
+        if (argc > 3) {
+            shape = parseShape(argv[3]);
+        } else {
+            Ort::SessionOptions probe_options;
+            Ort::Session probe(env, model_path, probe_options);
+            shape = probe.GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+            for (auto& d : shape) if (d < 0) d = 1;
+        }
+
+        // 2. Search space
+        const int hw = std::max(1u, std::thread::hardware_concurrency());
+        std::vector<int> intra_values;
+        for (int t = 1; t <= hw; t *= 2) intra_values.push_back(t);
+        if (intra_values.back() != hw) intra_values.push_back(hw);
+
+        std::vector<TunedOptions> candidates;
+        for (int intra : intra_values)
+        for (auto mode : {ExecutionMode::ORT_SEQUENTIAL, ExecutionMode::ORT_PARALLEL})
+        for (int inter : {1, 2})
+        for (auto level : {GraphOptimizationLevel::ORT_ENABLE_BASIC, GraphOptimizationLevel::ORT_ENABLE_EXTENDED,
+                           GraphOptimizationLevel::ORT_ENABLE_ALL})
+        for (bool mem_pattern : {true, false})
+        for (bool arena : {true, false}) {
+            // inter-op threads are only used by the parallel executor
+            if (mode == ExecutionMode::ORT_SEQUENTIAL && inter != 1) continue;
+            candidates.push_back({intra, inter, mode, level, mem_pattern, arena});
+        }
+
+        std::cout << "Model: " << model_path << " | Metric: " << metric << " | Runs/config: " << runs
+                  << " | Configs: " << candidates.size() << std::endl;
+
+        // 3. Sweep
+        TunedOptions best;
+        Measurement best_m;
+        bool have_best = false;
+        for (const auto& c : candidates) {
+            Measurement m = benchmark(env, model_path, c, shape, runs, throughput_metric);
+            bool better = !have_best ||
+                          (throughput_metric ? m.throughput > best_m.throughput : m.p99_ms < best_m.p99_ms);
+            if (better) {
+                best = c;
+                best_m = m;
+                have_best = true;
+            }
+            std::printf("%-60s p50 %7.3f ms | p99 %7.3f ms | %8.1f runs/s%s\n",
+                        describe(c).c_str(), m.p50_ms, m.p99_ms, m.throughput, better ? "  <- best" : "");
+        }
+
+        // 4. Persist the winner
+        saveTunedOptions(config_path, best, std::string("tuned for ") + model_path + ", metric " + metric);
+        std::cout << "\nBest: " << describe(best) << std::endl;
+        std::printf("      p50 %.3f ms | p99 %.3f ms | %.1f runs/s\n", best_m.p50_ms, best_m.p99_ms, best_m.throughput);
+        std::cout << "Saved to " << config_path << std::endl;
+
+        // 5. What the runtime does at startup
+        Ort::SessionOptions runtime_options;
+        TunedOptions loaded;
+        if (loadTunedSessionOptions(config_path, runtime_options, &loaded)) {
+            Ort::Session session(env, model_path, runtime_options);
+            std::cout << "Runtime session created with tuned options: " << describe(loaded) << std::endl;
+        }
+    }
+    catch (const Ort::Exception& e) {
+        std::cerr << "ONNX Runtime error: " << e.what() << std::endl;
+        return -1;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Standard exception: " << e.what() << std::endl;
+        return -1;
+    }
+
+    std::cout << "--- Tuning Complete ---" << std::endl;
+    return 0;
+}
@@ -0,0 +1,267 @@
+/*
+
+Why do we need an optimized-model cache?
+----------------------------------------------------
+09.Ort_ModelOptimization.cpp runs the full ORT_ENABLE_ALL graph optimization pass every time the process starts. The line that
+would keep the result is commented out:
+
+    // session_options.SetOptimizedModelFilePath("mnist_optimized.onnx");
+
+For MNIST this takes milliseconds. For YOLO-sized models in autoscaled pods, it adds seconds to every cold start, and the
+process repeats the same work on every start.
+
+ModelCache keeps the optimized model on disk, keyed by a hash of everything that affects the optimized graph:
+
+    key = hash(model bytes, ORT version, CPU feature tag, session-options tag, output format)
+
+    - Miss: create the session with ORT_ENABLE_ALL and SetOptimizedModelFilePath(<tmp>). Then rename <tmp> to
+            <cache>/<model>-<origin>-<key>.onnx (or .ort) so other processes never see a half-written file. <origin> hashes the
+            model's absolute path, the options tag and the format, so every configuration of every model has its own entries.
+    - Hit : load the cached file with ORT_DISABLE_ALL, so graph optimization is skipped entirely.
+    - ORT format: with "session.save_model_format" = "ORT" the cache stores the flatbuffer ORT format. It loads faster than
+            protobuf ONNX.
+
+Invalidation:
+
+    - Any change to the model, the ORT version, the CPU features or the options tag gives a new key, so stale entries are never
+      used. After a successful write, older entries with the same <origin> (a previous version of this model file under the
+      same options) are deleted. Other configurations, and same-named models from other directories, stay warm.
+    - If a cached file fails to load (truncated, corrupted), it is deleted and the entry is rebuilt as a miss.
+    - ./ort_model_cache --clear <cache dir> removes everything.
+
+The benchmark compares session creation without a cache, with a cold cache (optimize + save) and with a warm cache (load only),
+for both the ONNX and the ORT format.
+
+Usage:
+    ./ort_model_cache [model.onnx] [cache dir] [warm iterations]
+    ./ort_model_cache --clear [cache dir]
+
+*/
+
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <functional>
+#include <stdexcept>
+#include <filesystem>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+#include <onnxruntime_cxx_api.h>
+
+namespace fs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+
+// 64-bit FNV-1a; fast enough for multi-MB models and stable across runs/platforms
+struct Fnv1a64 {
+    uint64_t h = 1469598103934665603ULL;
+    void update(const void* data, size_t n) {
+        const auto* p = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < n; i++) {
+            h ^= p[i];
+            h *= 1099511628211ULL;
+        }
+    }
+    void update(const std::string& s) { update(s.data(), s.size() + 1); }   // include the terminator as separator
+};
+
+// Optimized graphs (e.g. NCHWc layouts, fused kernels) can depend on the instruction set of the CPU that produced them
+std::string cpuFeatureTag() {
+    std::string tag;
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) tag += "avx512f,";
+    if (__builtin_cpu_supports("avx2")) tag += "avx2,";
+    if (__builtin_cpu_supports("fma")) tag += "fma,";
+    if (__builtin_cpu_supports("avx")) tag += "avx,";
+#elif defined(__aarch64__)
+    tag = "aarch64";
+#endif
+    return tag;
+}
+
+class ModelCache {
+public:
+    explicit ModelCache(std::string cache_dir) : cache_dir_(std::move(cache_dir)) {
+        fs::create_directories(cache_dir_);
+    }
+
+    // configure applies the caller's non-optimization options (threads, EPs, ...); options_tag must describe them,
+    // because it is part of the cache key.
+    Ort::Session createSession(Ort::Env& env, const std::string& model_path,
+                               const std::function<void(Ort::SessionOptions&)>& configure,
+                               const std::string& options_tag, bool ort_format, bool* hit = nullptr) {
+        const std::string cached = cachePath(model_path, options_tag, ort_format);
+
+        // Hit: load the pre-optimized model and skip the optimization pass
+        if (fs::exists(cached)) {
+            try {
+                Ort::SessionOptions session_options;
+                configure(session_options);
+                session_options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_DISABLE_ALL);
+                if (ort_format) session_options.AddConfigEntry("session.load_model_format", "ORT");
+                Ort::Session session(env, cached.c_str(), session_options);
+                if (hit) *hit = true;
+                return session;
+            } catch (const Ort::Exception& e) {
+                std::cerr << "Cache entry " << cached << " is unusable (" << e.what() << "), rebuilding." << std::endl;
+                fs::remove(cached);
+            }
+        }
+
+        // Miss: optimize, save to a temporary file, then publish it atomically
+        const std::string tmp = cached + ".tmp" + std::to_string(static_cast<long long>(::getpid()));
+        Ort::SessionOptions session_options;
+        configure(session_options);
+        session_options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+        session_options.SetOptimizedModelFilePath(tmp.c_str());
+        if (ort_format) session_options.AddConfigEntry("session.save_model_format", "ORT");
+
+        Ort::Session session(env, model_path.c_str(), session_options);
+        std::error_code ec;
+        fs::rename(tmp, cached, ec);
+        if (ec) {
+            fs::remove(tmp, ec);
+        } else {
+            pruneStale(entryPrefix(model_path, options_tag, ort_format), cached);
+        }
+        if (hit) *hit = false;
+        return session;
+    }
+
+    void clear() {
+        for (const auto& entry : fs::directory_iterator(cache_dir_)) fs::remove_all(entry.path());
+    }
+
+    std::string cachePath(const std::string& model_path, const std::string& options_tag, bool ort_format) const {
+        std::ifstream in(model_path, std::ios::binary);
+        if (!in) throw std::runtime_error("cannot read model " + model_path);
+
+        Fnv1a64 hash;
+        std::vector<char> buf(1 << 20);
+        while (in) {
+            in.read(buf.data(), buf.size());
+            hash.update(buf.data(), static_cast<size_t>(in.gcount()));
+        }
+        hash.update(OrtGetApiBase()->GetVersionString());
+        hash.update(cpuFeatureTag());
+        hash.update(options_tag);
+        hash.update(ort_format ? "ort" : "onnx");
+
+        char key[17];
+        std::snprintf(key, sizeof(key), "%016llx", static_cast<unsigned long long>(hash.h));
+        return cache_dir_ + "/" + entryPrefix(model_path, options_tag, ort_format) + key + (ort_format ? ".ort" : ".onnx");
+    }
+
+private:
+    // "<stem>-<origin>-": origin identifies where the entry came from (model location + configuration), not its content
+    static std::string entryPrefix(const std::string& model_path, const std::string& options_tag, bool ort_format) {
+        Fnv1a64 origin;
+        origin.update(fs::absolute(model_path).lexically_normal().string());
+        origin.update(options_tag);
+        origin.update(ort_format ? "ort" : "onnx");
+        char tag[9];
+        std::snprintf(tag, sizeof(tag), "%08llx", static_cast<unsigned long long>(origin.h & 0xffffffffULL));
+        return fs::path(model_path).stem().string() + "-" + tag + "-";
+    }
+
+    // Remove older entries of the same origin (same prefix + extension, different content key)
+    void pruneStale(const std::string& prefix, const std::string& keep) {
+        const std::string ext = fs::path(keep).extension().string();
+        for (const auto& entry : fs::directory_iterator(cache_dir_)) {
+            const std::string name = entry.path().filename().string();
+            if (entry.path() != fs::path(keep) && name.rfind(prefix, 0) == 0 &&
+                entry.path().extension() == ext && name.size() == prefix.size() + 16 + ext.size()) {
+                fs::remove(entry.path());
+            }
+        }
+    }
+
+    std::string cache_dir_;
+};
+
+double msSince(Clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+}
+
+// ---------------- Main ----------------
+int main(int argc, char** argv) {
+    std::cout << "--- Optimized Model Cache Demo ---" << std::endl;
+
+    if (argc > 1 && std::strcmp(argv[1], "--clear") == 0) {
+        ModelCache cache(argc > 2 ? argv[2] : "/assets/cache");
+        cache.clear();
+        std::cout << "Cache cleared." << std::endl;
+        return 0;
+    }
+
+    const std::string model_path = argc > 1 ? argv[1] : "/assets/models/yolov10n.onnx";
+    const std::string cache_dir = argc > 2 ? argv[2] : "/assets/cache";
+    const int warm_iterations = argc > 3 ? std::max(1, std::atoi(argv[3])) : 5;
+
+    try {
+        Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "ModelCacheDemo");
+        ModelCache cache(cache_dir);
+
+        // Options that do not affect the optimized graph shape are still part of the tag, to keep the key honest
+        auto configure = [](Ort::SessionOptions& so) { so.SetIntraOpNumThreads(2); };
+        const std::string options_tag = "cpu;intra=2";
+
+        std::cout << "Model: " << model_path << " | Cache: " << cache_dir
+                  << " | ORT " << OrtGetApiBase()->GetVersionString() << std::endl;
+
+        // 1. Baseline: no cache, full optimization at every start (what 09.Ort_ModelOptimization.cpp does)
+        auto t0 = Clock::now();
+        {
+            Ort::SessionOptions session_options;
+            configure(session_options);
+            session_options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+            Ort::Session session(env, model_path.c_str(), session_options);
+        }
+        double baseline_ms = msSince(t0);
+
+        std::printf("\n%-8s | %12s | %12s | %12s | %s\n", "format", "no cache ms", "cold ms", "warm ms", "warm speedup");
+        for (bool ort_format : {false, true}) {
+            // 2. Cold: make sure this key is absent, then optimize + save
+            fs::remove(cache.cachePath(model_path, options_tag, ort_format));
+            bool hit = false;
+            t0 = Clock::now();
+            { Ort::Session session = cache.createSession(env, model_path, configure, options_tag, ort_format, &hit); }
+            double cold_ms = msSince(t0);
+
+            // 3. Warm: load from cache (hashing the model is included in the measured time)
+            double warm_ms = 0.0;
+            for (int i = 0; i < warm_iterations; i++) {
+                t0 = Clock::now();
+                { Ort::Session session = cache.createSession(env, model_path, configure, options_tag, ort_format, &hit); }
+                warm_ms += msSince(t0);
+                if (!hit) std::cerr << "Unexpected cache miss on warm iteration " << i << std::endl;
+            }
+            warm_ms /= warm_iterations;
+
+            std::printf("%-8s | %12.1f | %12.1f | %12.1f | %.2fx\n",
+                        ort_format ? "ORT" : "ONNX", baseline_ms, cold_ms, warm_ms, baseline_ms / warm_ms);
+        }
+
+        std::cout << "\nCache entries:" << std::endl;
+        for (const auto& entry : fs::directory_iterator(cache_dir)) {
+            std::cout << "  " << entry.path().filename().string() << " (" << fs::file_size(entry.path()) << " bytes)" << std::endl;
+        }
+    }
+    catch (const Ort::Exception& e) {
+        std::cerr << "ONNX Runtime error: " << e.what() << std::endl;
+        return -1;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Standard exception: " << e.what() << std::endl;
+        return -1;
+    }
+
+    std::cout << "--- Demo Complete ---" << std::endl;
+    return 0;
+}
@@ -0,0 +1,189 @@
+/*
+
+Why do we need memory-mapped loading and shared weights?
+----------------------------------------------------
+05.Ort_Session.cpp and 10.Ort_Detect_YOLOv10n.cpp create sessions from a file path. Every Ort::Session reads the file and keeps its own
+copy of the weights, and the CPU kernels keep another "prepacked" copy in their preferred layout (e.g. the blocked GEMM/Conv
+weights of MLAS). When we run several replicas of one model in a process (for concurrency, see 16.Ort_Inference_Server.cpp),
+resident memory grows linearly with the number of replicas.
+
+This demo loads the model differently:
+
+    1. mmap the model file once (read-only, MAP_PRIVATE). The pages live in the OS page cache and are shared by every replica
+       (and by every process that maps the same file).
+    2. Create every replica from that buffer: Ort::Session(env, data, size, options, prepacked_weights_container).
+    3. Share one Ort::PrepackedWeightsContainer between all replicas, so each weight is prepacked once and every replica points
+       at the same prepacked buffer.
+    4. For ORT-format models (.ort, see 19.Ort_Model_Cache.cpp), also set
+           session.use_ort_model_bytes_directly = 1
+           session.use_ort_model_bytes_for_initializers = 1
+       so the initializers point straight into the mapped file instead of being copied.
+       (ONNX protobuf models must be parsed, so their initializers are always copied once per session; only the prepacked
+       weights can be shared.)
+
+For each replica, the demo reports the RSS growth when the replica is created and when it first runs (activations and arena). It
+also reports the total RSS. Each mode runs in its own forked child process, so the numbers do not mix:
+
+    - "path"   : baseline, Ort::Session(env, path, options) per replica
+    - "shared" : mmap + shared PrepackedWeightsContainer (+ direct ORT bytes)
+
+With sharing enabled, each added replica should cost little more than its activation memory.
+
+Usage:
+    ./ort_shared_weights [model.onnx | model.ort] [replicas]
+
+*/
+
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <memory>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <onnxruntime_cxx_api.h>
+
+// Resident set size of this process in MB (Linux: /proc/self/statm, field 2 = resident pages)
+double rssMB() {
+    std::ifstream statm("/proc/self/statm");
+    long pages_total = 0, pages_resident = 0;
+    statm >> pages_total >> pages_resident;
+    return pages_resident * static_cast<double>(sysconf(_SC_PAGESIZE)) / (1024.0 * 1024.0);
+}
+
+// Read-only mapping of a whole file; unmapped on destruction
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("cannot open " + path);
+        struct stat st {};
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw std::runtime_error("cannot stat " + path);
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        data_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);   // the mapping keeps the file alive
+        if (data_ == MAP_FAILED) throw std::runtime_error("mmap failed for " + path);
+    }
+    ~MappedFile() { ::munmap(data_, size_); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const void* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    void* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+// One Run with a synthetic input so activations and the arena are allocated
+void warmUp(Ort::Session& session) {
+    Ort::AllocatorWithDefaultOptions allocator;
+    auto input_name = session.GetInputNameAllocated(0, allocator);
+    auto output_name = session.GetOutputNameAllocated(0, allocator);
+    const char* input_names[] = {input_name.get()};
+    const char* output_names[] = {output_name.get()};
+
+    std::vector<int64_t> shape = session.GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+    size_t count = 1;
+    for (auto& d : shape) {
+        if (d < 0) d = 1;
+        count *= static_cast<size_t>(d);
+    }
+    std::vector<float> data(count, 0.5f);
+    Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+    Ort::Value input = Ort::Value::CreateTensor<float>(memory_info, data.data(), data.size(), shape.data(), shape.size());
+    session.Run(Ort::RunOptions{nullptr}, input_names, &input, 1, output_names, 1);
+}
+
+bool endsWith(const std::string& s, const std::string& suffix) {
+    return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// Runs in a child process so each mode starts from a clean RSS baseline
+int runMode(const std::string& mode, const std::string& model_path, int replicas) {
+    const bool shared = mode == "shared";
+    const bool ort_format = endsWith(model_path, ".ort");
+
+    Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "SharedWeightsDemo");
+    Ort::SessionOptions session_options;
+    session_options.SetIntraOpNumThreads(1);
+    session_options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+    if (shared && ort_format) {
+        session_options.AddConfigEntry("session.use_ort_model_bytes_directly", "1");
+        session_options.AddConfigEntry("session.use_ort_model_bytes_for_initializers", "1");
+    }
+
+    const double rss_start = rssMB();
+    std::unique_ptr<MappedFile> mapped;
+    Ort::PrepackedWeightsContainer prepacked;
+    if (shared) mapped = std::make_unique<MappedFile>(model_path);
+
+    std::cout << "\n[" << mode << "] " << model_path << (ort_format ? " (ORT format)" : " (ONNX)")
+              << " | start RSS " << rssMB() << " MB" << std::endl;
+    std::cout << "replica | create +MB | first run +MB | total RSS MB" << std::endl;
+
+    std::vector<Ort::Session> sessions;
+    sessions.reserve(replicas);
+    for (int i = 0; i < replicas; i++) {
+        double before = rssMB();
+        if (shared) {
+            sessions.emplace_back(env, mapped->data(), mapped->size(), session_options, prepacked);
+        } else {
+            sessions.emplace_back(env, model_path.c_str(), session_options);
+        }
+        double created = rssMB();
+        warmUp(sessions.back());
+        double ran = rssMB();
+        std::printf("%7d | %10.1f | %13.1f | %12.1f\n", i, created - before, ran - created, ran);
+    }
+
+    std::printf("Total for %d replicas: %.1f MB (%.1f MB per replica)\n",
+                replicas, rssMB() - rss_start, (rssMB() - rss_start) / replicas);
+    return 0;
+}
+
+// ---------------- Main ----------------
+int main(int argc, char** argv) {
+    std::cout << "--- Memory-Mapped Loading + Shared Weights Demo ---" << std::endl;
+
+    const std::string model_path = argc > 1 ? argv[1] : "/assets/models/yolov10n.onnx";
+    const int replicas = argc > 2 ? std::max(1, std::atoi(argv[2])) : 4;
+
+    // fork before any ORT object exists, so the child starts single-threaded with a clean heap
+    for (const std::string mode : {"path", "shared"}) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            try {
+                std::exit(runMode(mode, model_path, replicas));
+            }
+            catch (const Ort::Exception& e) {
+                std::cerr << "ONNX Runtime error: " << e.what() << std::endl;
+            }
+            catch (const std::exception& e) {
+                std::cerr << "Standard exception: " << e.what() << std::endl;
+            }
+            std::exit(1);
+        }
+        int status = 0;
+        waitpid(pid, &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            std::cerr << "Mode '" << mode << "' failed." << std::endl;
+            return -1;
+        }
+    }
+
+    std::cout << "\n--- Demo Complete ---" << std::endl;
+    return 0;
+}
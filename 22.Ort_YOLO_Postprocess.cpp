@@ -0,0 +1,475 @@
+/*
+
+Why do we need a dedicated post-processing module?
+----------------------------------------------------
+The output loop in 10.Ort_Detect_YOLOv10n.cpp walks all 300 rows of the [1, 300, 6] output with scalar code and a hard-coded
+0.25f threshold. That only works for NMS-free YOLOv10 exports. YOLOv8 / YOLO11 exports return the raw detection head instead:
+
+    [1, 84, 8400]  = 4 box rows (cx, cy, w, h) + 80 class-score rows, for 8400 anchors, channel-major
+
+For these we must pick the best class per anchor, filter by confidence, keep the top-K candidates and run NMS ourselves. Done
+naively (per-anchor class loop with stride 8400, full sort, O(n^2) NMS over all classes) this can cost more than inference.
+
+YoloPostProcessor handles both formats:
+
+    - Class max     : with AVX2, loops classes outer / anchors inner, so every class row is read contiguously. The running
+                      max and argmax are updated 8 anchors at a time (compare + blend). The scalar fallback is branchless.
+    - Filter        : a vector compare + movemask turns 8 scores into a bitmask of candidate anchors.
+    - Top-K         : std::partial_sort keeps only the K best candidates sorted by score, instead of sorting all of them.
+    - NMS           : class-aware greedy NMS over structure-of-arrays boxes. Boxes are offset by class_id * 4096 so boxes of
+                      different classes never overlap, and one pass handles all classes. The IoU test against the remaining
+                      boxes is vectorized and has no division: inter > thr * union. It exits early once max_det boxes are kept.
+    - YOLOv10       : the confidence column (stride 6) is gathered 8 rows at a time and filtered the same way.
+    - Output        : Detections, a compact structure of arrays (x1, y1, x2, y2, score, class_id).
+
+All scratch buffers live in the processor and are reused, so steady-state calls do not allocate once capacity is reached.
+
+The benchmark compares naive and optimized code on synthetic outputs of both formats. If a model and image are given, it also runs
+a real model and auto-detects the output format from its shape.
+
+Usage:
+    ./ort_yolo_postprocess                                  -> synthetic benchmarks
+    ./ort_yolo_postprocess <model.onnx> <image>             -> also post-process a real model output
+
+*/
+
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <random>
+#include <numeric>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <onnxruntime_cxx_api.h>
+#include <opencv2/opencv.hpp>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define POST_X86 1
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+bool hasAVX2() {
+#ifdef POST_X86
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+// Compact structure-of-arrays detection list (model input coordinates)
+struct Detections {
+    std::vector<float> x1, y1, x2, y2, score;
+    std::vector<int> class_id;
+
+    size_t size() const { return score.size(); }
+    void clear() {
+        x1.clear(); y1.clear(); x2.clear(); y2.clear(); score.clear(); class_id.clear();
+    }
+    void push(float a, float b, float c, float d, float s, int cls) {
+        x1.push_back(a); y1.push_back(b); x2.push_back(c); y2.push_back(d); score.push_back(s); class_id.push_back(cls);
+    }
+};
+
+struct PostProcessConfig {
+    float conf_threshold = 0.25f;
+    float iou_threshold = 0.45f;
+    size_t max_candidates = 1000;   // top-K before NMS
+    size_t max_detections = 300;    // NMS early exit
+};
+
+class YoloPostProcessor {
+public:
+    YoloPostProcessor(PostProcessConfig config, bool use_simd) : config_(config), simd_(use_simd && hasAVX2()) {}
+
+    // YOLOv8 / YOLO11 raw head: data is [4 + num_classes, num_anchors], channel-major
+    void processRaw(const float* data, int num_classes, int num_anchors, Detections& out) {
+        out.clear();
+        best_score_.resize(num_anchors);
+        best_class_.resize(num_anchors);
+        candidates_.clear();
+
+        // 1. Per-anchor best class, classes outer / anchors inner
+        const float* scores = data + 4 * static_cast<size_t>(num_anchors);
+        if (simd_) classMaxAVX2(scores, num_classes, num_anchors);
+        else classMaxScalar(scores, num_classes, num_anchors);
+
+        // 2. Confidence filter
+        if (simd_) filterAVX2(best_score_.data(), num_anchors, 1, candidates_);
+        else filterScalar(best_score_.data(), num_anchors, 1, candidates_);
+
+        // 3. Top-K by score (partial sort only)
+        const size_t k = std::min(config_.max_candidates, candidates_.size());
+        std::partial_sort(candidates_.begin(), candidates_.begin() + k, candidates_.end(),
+                          [this](int a, int b) { return best_score_[a] > best_score_[b]; });
+        candidates_.resize(k);
+
+        // 4. Decode only the survivors into SoA boxes
+        boxes_.clear();
+        const float* cx = data;
+        const float* cy = data + num_anchors;
+        const float* w = data + 2 * static_cast<size_t>(num_anchors);
+        const float* h = data + 3 * static_cast<size_t>(num_anchors);
+        for (int a : candidates_) {
+            boxes_.push(cx[a] - 0.5f * w[a], cy[a] - 0.5f * h[a], cx[a] + 0.5f * w[a], cy[a] + 0.5f * h[a],
+                        best_score_[a], best_class_[a]);
+        }
+
+        // 5. Class-aware NMS
+        nms(boxes_, out);
+    }
+
+    // YOLOv10 NMS-free output: data is [num_rows, 6] = x1, y1, x2, y2, conf, class_id
+    void processNmsFree(const float* data, int num_rows, Detections& out) {
+        out.clear();
+        candidates_.clear();
+        if (simd_) filterAVX2(data + 4, num_rows, 6, candidates_);
+        else filterScalar(data + 4, num_rows, 6, candidates_);
+
+        for (int r : candidates_) {
+            const float* d = data + r * 6;
+            out.push(d[0], d[1], d[2], d[3], d[4], static_cast<int>(d[5]));
+        }
+    }
+
+private:
+    // Without SIMD, keeping the running max in a register (anchor outer) beats streaming the best_score_ array 80 times
+    void classMaxScalar(const float* scores, int num_classes, int n) {
+        for (int a = 0; a < n; a++) {
+            float best = scores[a];
+            int best_cls = 0;
+            for (int c = 1; c < num_classes; c++) {
+                const float s = scores[static_cast<size_t>(c) * n + a];
+                best_cls = s > best ? c : best_cls;
+                best = s > best ? s : best;
+            }
+            best_score_[a] = best;
+            best_class_[a] = best_cls;
+        }
+    }
+
+    // Indices of rows whose value (at data[row * stride]) passes the threshold
+    void filterScalar(const float* values, int n, int stride, std::vector<int>& out) const {
+        for (int i = 0; i < n; i++) {
+            if (values[static_cast<size_t>(i) * stride] >= config_.conf_threshold) out.push_back(i);
+        }
+    }
+
+#ifdef POST_X86
+    __attribute__((target("avx2")))
+    void classMaxAVX2(const float* scores, int num_classes, int n) {
+        std::copy(scores, scores + n, best_score_.begin());
+        std::fill(best_class_.begin(), best_class_.end(), 0);
+        const int vec_end = n - n % 8;
+        for (int c = 1; c < num_classes; c++) {
+            const float* row = scores + static_cast<size_t>(c) * n;
+            const __m256i cls = _mm256_set1_epi32(c);
+            int a = 0;
+            for (; a < vec_end; a += 8) {
+                __m256 s = _mm256_loadu_ps(row + a);
+                __m256 best = _mm256_loadu_ps(&best_score_[a]);
+                __m256 gt = _mm256_cmp_ps(s, best, _CMP_GT_OQ);
+                _mm256_storeu_ps(&best_score_[a], _mm256_blendv_ps(best, s, gt));
+                __m256i bc = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&best_class_[a]));
+                bc = _mm256_blendv_epi8(bc, cls, _mm256_castps_si256(gt));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(&best_class_[a]), bc);
+            }
+            for (; a < n; a++) {
+                if (row[a] > best_score_[a]) {
+                    best_score_[a] = row[a];
+                    best_class_[a] = c;
+                }
+            }
+        }
+    }
+
+    __attribute__((target("avx2")))
+    void filterAVX2(const float* values, int n, int stride, std::vector<int>& out) const {
+        const __m256 thr = _mm256_set1_ps(config_.conf_threshold);
+        const __m256i idx = _mm256_setr_epi32(0, stride, 2 * stride, 3 * stride, 4 * stride, 5 * stride, 6 * stride, 7 * stride);
+        int i = 0;
+        for (; i + 8 <= n; i += 8) {
+            const float* base = values + static_cast<size_t>(i) * stride;
+            __m256 v = stride == 1 ? _mm256_loadu_ps(base) : _mm256_i32gather_ps(base, idx, 4);
+            int mask = _mm256_movemask_ps(_mm256_cmp_ps(v, thr, _CMP_GE_OQ));
+            while (mask) {
+                int bit = __builtin_ctz(mask);
+                out.push_back(i + bit);
+                mask &= mask - 1;
+            }
+        }
+        for (; i < n; i++) {
+            if (values[static_cast<size_t>(i) * stride] >= config_.conf_threshold) out.push_back(i);
+        }
+    }
+
+    // Marks boxes [begin, n) that overlap box i by more than the IoU threshold
+    __attribute__((target("avx2")))
+    void suppressAVX2(size_t i, size_t begin, size_t n) {
+        const __m256 bx1 = _mm256_set1_ps(ox1_[i]), by1 = _mm256_set1_ps(oy1_[i]);
+        const __m256 bx2 = _mm256_set1_ps(ox2_[i]), by2 = _mm256_set1_ps(oy2_[i]);
+        const __m256 barea = _mm256_set1_ps(area_[i]);
+        const __m256 thr = _mm256_set1_ps(config_.iou_threshold);
+        const __m256 zero = _mm256_setzero_ps();
+        size_t j = begin;
+        for (; j + 8 <= n; j += 8) {
+            __m256 iw = _mm256_max_ps(zero, _mm256_sub_ps(_mm256_min_ps(bx2, _mm256_loadu_ps(&ox2_[j])),
+                                                          _mm256_max_ps(bx1, _mm256_loadu_ps(&ox1_[j]))));
+            __m256 ih = _mm256_max_ps(zero, _mm256_sub_ps(_mm256_min_ps(by2, _mm256_loadu_ps(&oy2_[j])),
+                                                          _mm256_max_ps(by1, _mm256_loadu_ps(&oy1_[j]))));
+            __m256 inter = _mm256_mul_ps(iw, ih);
+            __m256 uni = _mm256_sub_ps(_mm256_add_ps(barea, _mm256_loadu_ps(&area_[j])), inter);
+            __m256 over = _mm256_cmp_ps(inter, _mm256_mul_ps(thr, uni), _CMP_GT_OQ);
+            __m256i sup = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&suppressed_[j]));
+            sup = _mm256_or_si256(sup, _mm256_castps_si256(over));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(&suppressed_[j]), sup);
+        }
+        suppressScalar(i, j, n);
+    }
+#else
+    void classMaxAVX2(const float* scores, int num_classes, int n) { classMaxScalar(scores, num_classes, n); }
+    void filterAVX2(const float* values, int n, int stride, std::vector<int>& out) const { filterScalar(values, n, stride, out); }
+    void suppressAVX2(size_t i, size_t begin, size_t n) { suppressScalar(i, begin, n); }
+#endif
+
+    void suppressScalar(size_t i, size_t begin, size_t n) {
+        for (size_t j = begin; j < n; j++) {
+            float iw = std::max(0.f, std::min(ox2_[i], ox2_[j]) - std::max(ox1_[i], ox1_[j]));
+            float ih = std::max(0.f, std::min(oy2_[i], oy2_[j]) - std::max(oy1_[i], oy1_[j]));
+            float inter = iw * ih;
+            if (inter > config_.iou_threshold * (area_[i] + area_[j] - inter)) suppressed_[j] = -1;
+        }
+    }
+
+    // Greedy NMS over boxes already sorted by descending score
+    void nms(const Detections& in, Detections& out) {
+        const size_t n = in.size();
+        ox1_.resize(n); oy1_.resize(n); ox2_.resize(n); oy2_.resize(n); area_.resize(n);
+        suppressed_.assign(n, 0);
+
+        // Offset each class into its own region so different classes never overlap
+        for (size_t i = 0; i < n; i++) {
+            const float off = in.class_id[i] * 4096.0f;
+            ox1_[i] = in.x1[i] + off;
+            oy1_[i] = in.y1[i] + off;
+            ox2_[i] = in.x2[i] + off;
+            oy2_[i] = in.y2[i] + off;
+            area_[i] = (in.x2[i] - in.x1[i]) * (in.y2[i] - in.y1[i]);
+        }
+
+        for (size_t i = 0; i < n; i++) {
+            if (suppressed_[i]) continue;
+            out.push(in.x1[i], in.y1[i], in.x2[i], in.y2[i], in.score[i], in.class_id[i]);
+            if (out.size() >= config_.max_detections) break;   // early exit
+            if (simd_) suppressAVX2(i, i + 1, n);
+            else suppressScalar(i, i + 1, n);
+        }
+    }
+
+    PostProcessConfig config_;
+    bool simd_;
+    std::vector<float> best_score_;
+    std::vector<int> best_class_;
+    std::vector<int> candidates_;
+    Detections boxes_;
+    std::vector<float> ox1_, oy1_, ox2_, oy2_, area_;
+    std::vector<int32_t> suppressed_;
+};
+
+// ---------------- Naive references ----------------
+// The straightforward version: per-anchor class loop (stride = num_anchors), full sort, per-pair IoU with division
+void naiveRaw(const float* data, int num_classes, int n, const PostProcessConfig& cfg, Detections& out) {
+    out.clear();
+    struct Cand { float x1, y1, x2, y2, score; int cls; };
+    std::vector<Cand> cands;
+    for (int a = 0; a < n; a++) {
+        int best = 0;
+        float best_s = data[4 * n + a];
+        for (int c = 1; c < num_classes; c++) {
+            float s = data[(4 + c) * n + a];
+            if (s > best_s) { best_s = s; best = c; }
+        }
+        if (best_s < cfg.conf_threshold) continue;
+        float cx = data[a], cy = data[n + a], w = data[2 * n + a], h = data[3 * n + a];
+        cands.push_back({cx - w / 2, cy - h / 2, cx + w / 2, cy + h / 2, best_s, best});
+    }
+    std::sort(cands.begin(), cands.end(), [](const Cand& a, const Cand& b) { return a.score > b.score; });
+    if (cands.size() > cfg.max_candidates) cands.resize(cfg.max_candidates);
+
+    std::vector<bool> removed(cands.size(), false);
+    for (size_t i = 0; i < cands.size(); i++) {
+        if (removed[i]) continue;
+        if (out.size() < cfg.max_detections) {
+            out.push(cands[i].x1, cands[i].y1, cands[i].x2, cands[i].y2, cands[i].score, cands[i].cls);
+        }
+        for (size_t j = i + 1; j < cands.size(); j++) {
+            if (cands[j].cls != cands[i].cls) continue;
+            float iw = std::max(0.f, std::min(cands[i].x2, cands[j].x2) - std::max(cands[i].x1, cands[j].x1));
+            float ih = std::max(0.f, std::min(cands[i].y2, cands[j].y2) - std::max(cands[i].y1, cands[j].y1));
+            float inter = iw * ih;
+            float uni = (cands[i].x2 - cands[i].x1) * (cands[i].y2 - cands[i].y1) +
+                        (cands[j].x2 - cands[j].x1) * (cands[j].y2 - cands[j].y1) - inter;
+            if (inter / uni > cfg.iou_threshold) removed[j] = true;
+        }
+    }
+}
+
+// The loop from 10.Ort_Detect_YOLOv10n.cpp
+void naiveNmsFree(const float* data, int num_rows, const PostProcessConfig& cfg, Detections& out) {
+    out.clear();
+    for (int i = 0; i < num_rows; i++) {
+        const float* d = data + i * 6;
+        if (d[4] < cfg.conf_threshold) continue;
+        out.push(d[0], d[1], d[2], d[3], d[4], static_cast<int>(d[5]));
+    }
+}
+
+// ---------------- Synthetic outputs ----------------
+// Raw head with `objects` objects, each seen by ~40 neighbouring anchors (so NMS has real work), background scores ~0.01
+std::vector<float> syntheticRaw(int num_classes, int n, int objects, std::mt19937& rng) {
+    std::vector<float> data(static_cast<size_t>(4 + num_classes) * n);
+    std::uniform_real_distribution<float> pos(0.f, 640.f), size(10.f, 200.f), low(0.f, 0.02f), jitter(-4.f, 4.f), high(0.5f, 0.95f);
+    for (int a = 0; a < n; a++) {
+        data[a] = pos(rng); data[n + a] = pos(rng); data[2 * n + a] = size(rng); data[3 * n + a] = size(rng);
+    }
+    for (size_t i = 4 * static_cast<size_t>(n); i < data.size(); i++) data[i] = low(rng);
+    for (int o = 0; o < objects; o++) {
+        float cx = pos(rng), cy = pos(rng), w = size(rng), h = size(rng);
+        int cls = static_cast<int>(rng() % num_classes);
+        for (int k = 0; k < 40; k++) {
+            int a = static_cast<int>(rng() % n);
+            data[a] = cx + jitter(rng); data[n + a] = cy + jitter(rng);
+            data[2 * n + a] = w + jitter(rng); data[3 * n + a] = h + jitter(rng);
+            data[static_cast<size_t>(4 + cls) * n + a] = high(rng);
+        }
+    }
+    return data;
+}
+
+std::vector<float> syntheticNmsFree(int rows, int above, std::mt19937& rng) {
+    std::vector<float> data(rows * 6);
+    std::uniform_real_distribution<float> pos(0.f, 600.f);
+    for (int r = 0; r < rows; r++) {
+        float x = pos(rng), y = pos(rng);
+        float conf = r < above ? 0.9f - 0.6f * r / above : 0.2f * (rows - r) / rows;   // sorted, like YOLOv10
+        float row[6] = {x, y, x + 40, y + 40, conf, static_cast<float>(rng() % 80)};
+        std::copy(row, row + 6, data.begin() + r * 6);
+    }
+    return data;
+}
+
+template <typename Fn>
+double timeUs(Fn&& fn, int iterations) {
+    fn();
+    auto t0 = Clock::now();
+    for (int i = 0; i < iterations; i++) fn();
+    return std::chrono::duration<double, std::micro>(Clock::now() - t0).count() / iterations;
+}
+
+// ---------------- Main ----------------
+int main(int argc, char** argv) {
+    std::cout << "--- YOLO Post-Processing (raw head + NMS-free) Demo ---" << std::endl;
+    std::cout << "AVX2 available: " << (hasAVX2() ? "yes" : "no") << std::endl;
+
+    PostProcessConfig cfg;
+    YoloPostProcessor fast_scalar(cfg, false), fast_simd(cfg, true);
+    Detections dets;
+    std::mt19937 rng(42);
+    const int iterations = 200;
+
+    // 1. YOLOv8/YOLO11 raw head [1, 84, 8400]
+    const int num_classes = 80, num_anchors = 8400;
+    auto raw = syntheticRaw(num_classes, num_anchors, 30, rng);
+    double t_naive = timeUs([&] { naiveRaw(raw.data(), num_classes, num_anchors, cfg, dets); }, iterations);
+    size_t n_naive = dets.size();
+    double t_scalar = timeUs([&] { fast_scalar.processRaw(raw.data(), num_classes, num_anchors, dets); }, iterations);
+    double t_simd = timeUs([&] { fast_simd.processRaw(raw.data(), num_classes, num_anchors, dets); }, iterations);
+
+    std::printf("\n[1, 84, 8400] raw head\n");
+    std::printf("  naive            %9.1f us  (%zu detections)\n", t_naive, n_naive);
+    std::printf("  optimized scalar %9.1f us  (%.2fx)\n", t_scalar, t_naive / t_scalar);
+    std::printf("  optimized AVX2   %9.1f us  (%.2fx, %zu detections)\n", t_simd, t_naive / t_simd, dets.size());
+
+    // 2. YOLOv10 NMS-free [1, 300, 6]
+    auto v10 = syntheticNmsFree(300, 20, rng);
+    t_naive = timeUs([&] { naiveNmsFree(v10.data(), 300, cfg, dets); }, iterations * 10);
+    n_naive = dets.size();
+    t_simd = timeUs([&] { fast_simd.processNmsFree(v10.data(), 300, dets); }, iterations * 10);
+
+    std::printf("\n[1, 300, 6] NMS-free\n");
+    std::printf("  naive            %9.2f us  (%zu detections)\n", t_naive, n_naive);
+    std::printf("  optimized AVX2   %9.2f us  (%.2fx, %zu detections)\n", t_simd, t_naive / t_simd, dets.size());
+
+    // 3. Optional: real model, format detected from the output shape
+    if (argc > 2) {
+        try {
+            Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "YOLOPostprocess");
+            Ort::SessionOptions session_options;
+            session_options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+            Ort::Session session(env, argv[1], session_options);
+
+            cv::Mat image = cv::imread(argv[2]);
+            if (image.empty()) {
+                std::cerr << " Error: could not load image at " << argv[2] << std::endl;
+                return -1;
+            }
+            const int input_w = 640, input_h = 640;
+            cv::Mat resized;
+            cv::resize(image, resized, cv::Size(input_w, input_h));
+            resized.convertTo(resized, CV_32F, 1.0 / 255.0);
+            std::vector<float> input_values(3 * input_w * input_h);
+            std::vector<cv::Mat> channels = {
+                cv::Mat(input_h, input_w, CV_32F, input_values.data()),
+                cv::Mat(input_h, input_w, CV_32F, input_values.data() + input_w * input_h),
+                cv::Mat(input_h, input_w, CV_32F, input_values.data() + 2 * input_w * input_h)};
+            cv::split(resized, channels);
+
+            std::vector<int64_t> input_shape = {1, 3, input_h, input_w};
+            Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+            Ort::Value input_tensor = Ort::Value::CreateTensor<float>(
+                memory_info, input_values.data(), input_values.size(), input_shape.data(), input_shape.size());
+
+            Ort::AllocatorWithDefaultOptions allocator;
+            auto input_name = session.GetInputNameAllocated(0, allocator);
+            auto output_name = session.GetOutputNameAllocated(0, allocator);
+            const char* input_names[] = {input_name.get()};
+            const char* output_names[] = {output_name.get()};
+            auto outputs = session.Run(Ort::RunOptions{nullptr}, input_names, &input_tensor, 1, output_names, 1);
+
+            const float* out = outputs[0].GetTensorData<float>();
+            auto shape = outputs[0].GetTensorTypeAndShapeInfo().GetShape();
+            dets.clear();   // still holds the synthetic benchmark's detections
+            if (shape.size() == 3 && shape[2] == 6) {
+                fast_simd.processNmsFree(out, static_cast<int>(shape[1]), dets);
+                std::cout << "\nNMS-free output [1, " << shape[1] << ", 6]: " << dets.size() << " detections" << std::endl;
+            } else if (shape.size() == 3) {
+                fast_simd.processRaw(out, static_cast<int>(shape[1] - 4), static_cast<int>(shape[2]), dets);
+                std::cout << "\nRaw head [1, " << shape[1] << ", " << shape[2] << "]: " << dets.size() << " detections" << std::endl;
+            } else {
+                std::cerr << "\nUnsupported output rank " << shape.size() << " (expected [1, N, 6] or [1, 4 + C, N])" << std::endl;
+            }
+
+            const float sx = static_cast<float>(image.cols) / input_w, sy = static_cast<float>(image.rows) / input_h;
+            for (size_t i = 0; i < dets.size(); i++) {
+                std::printf("  cls %2d  %.2f  [%.0f, %.0f, %.0f, %.0f]\n", dets.class_id[i], dets.score[i],
+                            dets.x1[i] * sx, dets.y1[i] * sy, dets.x2[i] * sx, dets.y2[i] * sy);
+            }
+        }
+        catch (const Ort::Exception& e) {
+            std::cerr << "ONNX Runtime error: " << e.what() << std::endl;
+            return -1;
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Standard exception: " << e.what() << std::endl;
+            return -1;
+        }
+    }
+
+    std::cout << "--- Demo Complete ---" << std::endl;
+    return 0;
+}
@@ -0,0 +1,253 @@
+/*
+
+Why do we need asynchronous inference?
+----------------------------------------------------
+08.Ort_Session_Run.cpp and 10.Ort_Detect_YOLOv10n.cpp call the blocking session.Run(). While the model runs, the calling thread only
+waits: it cannot decode or preprocess the next frame. In a video loop the frame time is then preprocess + inference + postprocess.
+
+Ort::Session::RunAsync starts the run and returns immediately. When the outputs are ready, ORT calls a callback on one of its
+intra-op threads. AsyncSession wraps it in a std::future:
+
+    std::future<std::vector<Ort::Value>> f = async_session.runAsync(std::move(input), shape);
+    ... preprocess the next frame ...
+    std::vector<Ort::Value> outputs = f.get();
+
+Each request owns its input buffer, its input Value and its output Values, because ORT reads and writes them after runAsync
+returns. The request is freed in the callback after the promise is fulfilled. An error status from ORT is delivered as an
+exception through the future.
+
+Requirements and notes:
+
+    - RunAsync executes on the session's intra-op thread pool and needs at least 2 intra-op threads. AsyncSession enforces this.
+    - Outputs are passed as empty Values, so ORT allocates them. Their ownership moves into the future's result.
+    - The callback runs on an ORT thread. It must be short; here it only fulfils the promise.
+    - session.intra_op.allow_spinning=0 keeps idle ORT threads from spinning on the cores the preprocessing thread needs.
+    - Several requests may be in flight on one session. The demo keeps a window of `depth` requests.
+    - The repo builds with -std=c++17, so this uses futures rather than a C++20 coroutine awaitable. An awaitable would resume
+      the coroutine from the same callback.
+
+The demo runs YOLOv10n over a sequence of frames:
+
+    - blocking : preprocess(N) -> Run(N) -> postprocess(N), one after another
+    - async    : preprocess(N+1) and postprocess(N-1) overlap with the inference of N (depth 1, 2, 4)
+
+It reports frames/s and the speedup for each mode.
+
+Usage:
+    ./ort_async_inference [model.onnx] [image] [frames]
+
+*/
+
+
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <string>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdio>
+#include <cstdlib>
+#include <onnxruntime_cxx_api.h>
+#include <opencv2/opencv.hpp>
+
+using Clock = std::chrono::steady_clock;
+
+class AsyncSession {
+public:
+    AsyncSession(Ort::Env& env, const std::string& model_path, Ort::SessionOptions& session_options)
+        : session_(env, model_path.c_str(), session_options) {
+        Ort::AllocatorWithDefaultOptions allocator;
+        for (size_t i = 0; i < session_.GetInputCount(); i++) {
+            input_names_.emplace_back(session_.GetInputNameAllocated(i, allocator).get());
+        }
+        for (size_t i = 0; i < session_.GetOutputCount(); i++) {
+            output_names_.emplace_back(session_.GetOutputNameAllocated(i, allocator).get());
+        }
+        if (input_names_.size() != 1) throw std::runtime_error("AsyncSession expects a single-input model");
+        for (auto& name : output_names_) output_name_ptrs_.push_back(name.c_str());
+        input_name_ptr_ = input_names_[0].c_str();
+    }
+
+    // RunAsync runs on the intra-op pool and fails with fewer than 2 threads
+    static void configure(Ort::SessionOptions& session_options, int intra_threads) {
+        session_options.SetIntraOpNumThreads(std::max(2, intra_threads));
+        session_options.AddConfigEntry("session.intra_op.allow_spinning", "0");
+        session_options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+    }
+
+    // Takes ownership of the input buffer; the future yields all model outputs
+    std::future<std::vector<Ort::Value>> runAsync(std::vector<float> input, std::vector<int64_t> shape) {
+        auto request = std::make_unique<Request>();
+        request->owner = this;
+        request->input_data = std::move(input);
+        request->shape = std::move(shape);
+        request->input = Ort::Value::CreateTensor<float>(memory_info_, request->input_data.data(), request->input_data.size(),
+                                                         request->shape.data(), request->shape.size());
+        for (size_t i = 0; i < output_name_ptrs_.size(); i++) request->outputs.emplace_back(nullptr);   // ORT allocates them
+        auto future = request->promise.get_future();
+
+        in_flight_++;
+        try {
+            session_.RunAsync(Ort::RunOptions{nullptr}, &input_name_ptr_, &request->input, 1,
+                              output_name_ptrs_.data(), request->outputs.data(), output_name_ptrs_.size(),
+                              &AsyncSession::onComplete, request.get());
+        } catch (...) {
+            in_flight_--;
+            throw;
+        }
+        request.release();   // owned by the callback from now on
+        return future;
+    }
+
+    int inFlight() const { return in_flight_.load(); }
+    Ort::Session& session() { return session_; }
+    const char* inputName() const { return input_name_ptr_; }
+    const std::vector<const char*>& outputNames() const { return output_name_ptrs_; }
+
+private:
+    struct Request {
+        AsyncSession* owner = nullptr;
+        std::vector<float> input_data;
+        std::vector<int64_t> shape;
+        Ort::Value input{nullptr};
+        std::vector<Ort::Value> outputs;
+        std::promise<std::vector<Ort::Value>> promise;
+    };
+
+    // Called on an ORT intra-op thread; outputs point into request->outputs, which already own them
+    static void onComplete(void* user_data, OrtValue** /*outputs*/, size_t /*num_outputs*/, OrtStatusPtr status_ptr) {
+        std::unique_ptr<Request> request(static_cast<Request*>(user_data));
+        Ort::Status status(status_ptr);
+        request->owner->in_flight_--;   // before waking the waiter, which may destroy the session
+        if (status.IsOK()) {
+            request->promise.set_value(std::move(request->outputs));
+        } else {
+            request->promise.set_exception(std::make_exception_ptr(std::runtime_error(status.GetErrorMessage())));
+        }
+    }
+
+    Ort::Session session_;
+    Ort::MemoryInfo memory_info_ = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+    std::vector<std::string> input_names_, output_names_;
+    const char* input_name_ptr_ = nullptr;
+    std::vector<const char*> output_name_ptrs_;
+    std::atomic<int> in_flight_{0};
+};
+
+// Resize + normalize + HWC -> CHW into a fresh buffer (the request takes ownership of it)
+std::vector<float> preprocess(const cv::Mat& image, int input_w, int input_h) {
+    cv::Mat resized;
+    cv::resize(image, resized, cv::Size(input_w, input_h));
+    resized.convertTo(resized, CV_32F, 1.0 / 255.0);
+
+    std::vector<float> data(3 * static_cast<size_t>(input_w) * input_h);
+    const size_t plane = static_cast<size_t>(input_w) * input_h;
+    std::vector<cv::Mat> channels = {
+        cv::Mat(input_h, input_w, CV_32F, data.data()),
+        cv::Mat(input_h, input_w, CV_32F, data.data() + plane),
+        cv::Mat(input_h, input_w, CV_32F, data.data() + 2 * plane)};
+    cv::split(resized, channels);
+    return data;
+}
+
+// Counts detections above the threshold in the [1, N, 6] output
+int postprocess(const std::vector<Ort::Value>& outputs) {
+    const float* data = outputs[0].GetTensorData<float>();
+    auto shape = outputs[0].GetTensorTypeAndShapeInfo().GetShape();
+    int count = 0;
+    for (int64_t i = 0; i < shape[1]; i++) {
+        if (data[i * shape[2] + 4] >= 0.25f) count++;
+    }
+    return count;
+}
+
+double framesPerSecond(int frames, Clock::time_point t0) {
+    return frames / std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+// ---------------- Main ----------------
+int main(int argc, char** argv) {
+    try {
+        std::cout << "--- Asynchronous Inference (RunAsync + std::future) Demo ---" << std::endl;
+
+        const std::string model_path = argc > 1 ? argv[1] : "/assets/models/yolov10n.onnx";
+        const std::string image_path = argc > 2 ? argv[2] : "/assets/images/car.png";
+        const int frames = argc > 3 ? std::max(1, std::atoi(argv[3])) : 100;
+        const int input_w = 640, input_h = 640;
+        const std::vector<int64_t> input_shape = {1, 3, input_h, input_w};
+
+        cv::Mat image = cv::imread(image_path);
+        if (image.empty()) {
+            std::cerr << " Error: could not load image at " << image_path << std::endl;
+            return -1;
+        }
+
+        // Leave one core for the preprocessing thread
+        const int hw = static_cast<int>(std::max(2u, std::thread::hardware_concurrency()));
+        Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "AsyncInferenceDemo");
+        Ort::SessionOptions session_options;
+        AsyncSession::configure(session_options, hw - 1);
+        AsyncSession async_session(env, model_path, session_options);
+        std::cout << "Model: " << model_path << " | frames: " << frames << " | intra-op threads: " << std::max(2, hw - 1) << std::endl;
+
+        // 1. Blocking baseline on the same session: every stage waits for the previous one
+        Ort::Session& session = async_session.session();
+        Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+        const char* input_name = async_session.inputName();
+        const auto& output_names = async_session.outputNames();
+        int detections = 0;
+
+        auto run_blocking = [&]() {
+            std::vector<float> input = preprocess(image, input_w, input_h);
+            Ort::Value tensor = Ort::Value::CreateTensor<float>(memory_info, input.data(), input.size(),
+                                                                input_shape.data(), input_shape.size());
+            auto outputs = session.Run(Ort::RunOptions{nullptr}, &input_name, &tensor, 1,
+                                       output_names.data(), output_names.size());
+            detections = postprocess(outputs);
+        };
+        run_blocking();   // warm-up
+
+        auto t0 = Clock::now();
+        for (int i = 0; i < frames; i++) run_blocking();
+        const double blocking_fps = framesPerSecond(frames, t0);
+        std::printf("\n%-10s | %5s | %8s | %7s | %s\n", "mode", "depth", "frames/s", "speedup", "detections (last frame)");
+        std::printf("%-10s | %5s | %8.1f | %6.2fx | %d\n", "blocking", "-", blocking_fps, 1.0, detections);
+
+        // 2. Async: keep up to `depth` frames in flight. Preprocessing frame N+1 (and postprocessing older frames)
+        //    happens on this thread while ORT runs frame N.
+        for (int depth : {1, 2, 4}) {
+            std::deque<std::future<std::vector<Ort::Value>>> in_flight;
+            t0 = Clock::now();
+            for (int i = 0; i < frames; i++) {
+                std::vector<float> input = preprocess(image, input_w, input_h);
+                if (static_cast<int>(in_flight.size()) == depth) {
+                    detections = postprocess(in_flight.front().get());
+                    in_flight.pop_front();
+                }
+                in_flight.push_back(async_session.runAsync(std::move(input), input_shape));
+            }
+            while (!in_flight.empty()) {
+                detections = postprocess(in_flight.front().get());
+                in_flight.pop_front();
+            }
+            const double fps = framesPerSecond(frames, t0);
+            std::printf("%-10s | %5d | %8.1f | %6.2fx | %d\n", "async", depth, fps, fps / blocking_fps, detections);
+        }
+    }
+    catch (const Ort::Exception& e) {
+        std::cerr << "ONNX Runtime error: " << e.what() << std::endl;
+        return -1;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Standard exception: " << e.what() << std::endl;
+        return -1;
+    }
+
+    std::cout << "--- Demo Complete ---" << std::endl;
+    return 0;
+}
@@ -0,0 +1,475 @@
+/*
+
+Why do we need per-stage tracing?
+----------------------------------------------------
+10.Ort_Detect_YOLOv10n.cpp prints the output shape and nothing else. When a detection takes 40 ms, we cannot tell whether the time
+went into imread, resize/normalize, building the tensor, Session::Run, post-processing or imwrite. A single end-to-end timer does not
+help either: it hides tail latency, and it mixes stages that scale differently.
+
+This demo adds a small instrumentation layer:
+
+    {
+        ScopedTimer t(Stage::Run);          // one line per stage
+        outputs = session.Run(...);
+    }
+
+    - Near-zero cost when off: ScopedTimer checks one relaxed atomic flag and does not read the clock if tracing is disabled.
+      Compiling with -DSTAGE_TRACING=0 removes the timers entirely.
+    - Lock-free recording: each thread owns its histograms. A sample is one relaxed load + store of a counter; the thread is the
+      only writer, so no atomic read-modify-write and no shared cache lines are needed. The mutex is taken only once per thread,
+      to register its histograms.
+    - Histograms are log-linear: 8 sub-buckets per power of two of nanoseconds, so the relative error is at most 12.5%
+      from 1 ns to hours, in a fixed 496-bucket array.
+    - Export: the exporter merges all threads with relaxed loads and computes p50/p90/p99, count and sum per stage as
+        * Prometheus text (a summary metric, stage label), and
+        * JSON.
+    - Scraping: with --serve <port>, a background thread answers HTTP GET requests with the Prometheus text, so a long-running
+      process can be scraped directly. It listens on 127.0.0.1 only; add --serve-all to listen on every interface (e.g. for a
+      Prometheus server on another host). A client gets 2 s to send its request, so a silent connection cannot stall the thread.
+
+The demo runs the YOLOv10n detection of 10.Ort_Detect_YOLOv10n.cpp in a loop on two threads, then prints and writes both exports.
+It also measures the cost of an empty timed scope with tracing enabled and disabled.
+
+Usage:
+    ./ort_stage_tracing [iterations] [--serve <port>] [--serve-all]
+
+*/
+
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <memory>
+#include <exception>
+#include <array>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <onnxruntime_cxx_api.h>
+#include <opencv2/opencv.hpp>
+
+#ifndef STAGE_TRACING
+#define STAGE_TRACING 1
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+enum class Stage { ImRead, Preprocess, TensorBuild, Run, Postprocess, ImWrite, Count };
+constexpr int kStageCount = static_cast<int>(Stage::Count);
+const char* kStageNames[kStageCount] = {"imread", "preprocess", "tensor_build", "run", "postprocess", "imwrite"};
+
+// Log-linear histogram of nanoseconds with a single writer thread
+class Histogram {
+public:
+    static constexpr int kBuckets = 496;
+
+    static int bucketOf(uint64_t ns) {
+        if (ns < 8) return static_cast<int>(ns);
+        const int e = 63 - __builtin_clzll(ns);           // >= 3
+        const int sub = static_cast<int>((ns >> (e - 3)) & 7);
+        return (e - 2) * 8 + sub;
+    }
+    static double bucketMid(int b) {
+        if (b < 8) return b;
+        const int e = b / 8 + 2, sub = b % 8;
+        const double lower = static_cast<double>(uint64_t(8 + sub) << (e - 3));
+        return lower + static_cast<double>(uint64_t(1) << (e - 3)) / 2.0;
+    }
+
+    // Single writer: plain load + store is enough, readers see a consistent-enough snapshot
+    void record(uint64_t ns) {
+        auto& bucket = buckets_[bucketOf(ns)];
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        count_.store(count_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        sum_.store(sum_.load(std::memory_order_relaxed) + ns, std::memory_order_relaxed);
+    }
+
+    void reset() {
+        for (auto& bucket : buckets_) bucket.store(0, std::memory_order_relaxed);
+        count_.store(0, std::memory_order_relaxed);
+        sum_.store(0, std::memory_order_relaxed);
+    }
+
+    void mergeInto(std::vector<uint64_t>& buckets, uint64_t& count, uint64_t& sum) const {
+        for (int b = 0; b < kBuckets; b++) buckets[b] += buckets_[b].load(std::memory_order_relaxed);
+        count += count_.load(std::memory_order_relaxed);
+        sum += sum_.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::array<std::atomic<uint64_t>, kBuckets> buckets_{};
+    std::atomic<uint64_t> count_{0}, sum_{0};
+};
+
+struct StageSummary {
+    std::string name;
+    uint64_t count = 0;
+    double sum_ms = 0, p50_ms = 0, p90_ms = 0, p99_ms = 0;
+};
+
+class Tracer {
+public:
+    static Tracer& instance() {
+        static Tracer tracer;
+        return tracer;
+    }
+
+    void setEnabled(bool on) { enabled_.store(on, std::memory_order_relaxed); }
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    void record(Stage stage, uint64_t ns) { local()[static_cast<int>(stage)].record(ns); }
+
+    // Only valid while no thread is recording (the histograms have a single writer)
+    void reset() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& thread_hists : threads_) {
+            for (auto& h : *thread_hists) h.reset();
+        }
+    }
+
+    std::vector<StageSummary> summarize() const {
+        std::vector<StageSummary> out;
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (int s = 0; s < kStageCount; s++) {
+            std::vector<uint64_t> buckets(Histogram::kBuckets, 0);
+            uint64_t count = 0, sum = 0;
+            for (const auto& thread_hists : threads_) (*thread_hists)[s].mergeInto(buckets, count, sum);
+
+            StageSummary summary;
+            summary.name = kStageNames[s];
+            summary.count = count;
+            summary.sum_ms = sum / 1e6;
+            summary.p50_ms = quantile(buckets, count, 0.50);
+            summary.p90_ms = quantile(buckets, count, 0.90);
+            summary.p99_ms = quantile(buckets, count, 0.99);
+            out.push_back(summary);
+        }
+        return out;
+    }
+
+    std::string prometheus() const {
+        std::ostringstream os;
+        os << "# HELP ort_stage_latency_seconds Per-stage latency of the detection pipeline.\n";
+        os << "# TYPE ort_stage_latency_seconds summary\n";
+        for (const auto& s : summarize()) {
+            const std::pair<const char*, double> quantiles[] = {{"0.5", s.p50_ms}, {"0.9", s.p90_ms}, {"0.99", s.p99_ms}};
+            for (const auto& q : quantiles) {
+                os << "ort_stage_latency_seconds{stage=\"" << s.name << "\",quantile=\"" << q.first << "\"} " << q.second / 1e3 << "\n";
+            }
+            os << "ort_stage_latency_seconds_sum{stage=\"" << s.name << "\"} " << s.sum_ms / 1e3 << "\n";
+            os << "ort_stage_latency_seconds_count{stage=\"" << s.name << "\"} " << s.count << "\n";
+        }
+        return os.str();
+    }
+
+    std::string json() const {
+        std::ostringstream os;
+        os << "{\"stages\": [";
+        bool first = true;
+        for (const auto& s : summarize()) {
+            os << (first ? "" : ", ") << "{\"name\": \"" << s.name << "\", \"count\": " << s.count
+               << ", \"sum_ms\": " << s.sum_ms << ", \"p50_ms\": " << s.p50_ms
+               << ", \"p90_ms\": " << s.p90_ms << ", \"p99_ms\": " << s.p99_ms << "}";
+            first = false;
+        }
+        os << "]}";
+        return os.str();
+    }
+
+private:
+    using ThreadHistograms = std::array<Histogram, kStageCount>;
+
+    // Histograms are registered once per thread and kept after the thread exits, so its samples stay in the totals
+    ThreadHistograms& local() {
+        thread_local ThreadHistograms* hists = nullptr;
+        if (!hists) {
+            auto owned = std::make_unique<ThreadHistograms>();
+            hists = owned.get();
+            std::lock_guard<std::mutex> lock(mutex_);
+            threads_.push_back(std::move(owned));
+        }
+        return *hists;
+    }
+
+    static double quantile(const std::vector<uint64_t>& buckets, uint64_t count, double q) {
+        if (count == 0) return 0.0;
+        const uint64_t rank = static_cast<uint64_t>(q * (count - 1)) + 1;
+        uint64_t seen = 0;
+        for (int b = 0; b < Histogram::kBuckets; b++) {
+            seen += buckets[b];
+            if (seen >= rank) return Histogram::bucketMid(b) / 1e6;
+        }
+        return 0.0;
+    }
+
+    std::atomic<bool> enabled_{false};
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<ThreadHistograms>> threads_;
+};
+
+#if STAGE_TRACING
+class ScopedTimer {
+public:
+    explicit ScopedTimer(Stage stage) : stage_(stage), active_(Tracer::instance().enabled()) {
+        if (active_) start_ = Clock::now();
+    }
+    ~ScopedTimer() {
+        if (active_) {
+            auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start_).count();
+            Tracer::instance().record(stage_, static_cast<uint64_t>(ns));
+        }
+    }
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    Stage stage_;
+    bool active_;
+    Clock::time_point start_;
+};
+#else
+struct ScopedTimer {
+    explicit ScopedTimer(Stage) {}
+};
+#endif
+
+// Minimal HTTP endpoint: every connection gets the current Prometheus text.
+// Destroying the server (e.g. while an exception unwinds main) shuts the socket down, which unblocks accept(), and joins.
+// Per-connection send/receive timeouts bound how long a client can hold the thread, and therefore how long the join can take.
+class MetricsServer {
+public:
+    MetricsServer(int port, bool all_interfaces) {
+        fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (fd_ < 0) return;
+        int yes = 1;
+        ::setsockopt(fd_, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(all_interfaces ? INADDR_ANY : INADDR_LOOPBACK);
+        addr.sin_port = htons(static_cast<uint16_t>(port));
+        if (::bind(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || ::listen(fd_, 8) != 0) {
+            std::cerr << "Cannot listen on port " << port << std::endl;
+            ::close(fd_);
+            fd_ = -1;
+            return;
+        }
+        std::cout << "Serving Prometheus metrics on http://" << (all_interfaces ? "0.0.0.0" : "127.0.0.1") << ":" << port
+                  << "/metrics" << std::endl;
+        thread_ = std::thread([this] { serve(); });
+    }
+
+    ~MetricsServer() {
+        stopping_ = true;
+        if (fd_ >= 0) ::shutdown(fd_, SHUT_RDWR);
+        wait();
+        if (fd_ >= 0) ::close(fd_);
+    }
+
+    bool running() const { return thread_.joinable(); }
+    void wait() {
+        if (thread_.joinable()) thread_.join();
+    }
+
+private:
+    void serve() {
+        while (!stopping_) {
+            int client = ::accept(fd_, nullptr, nullptr);
+            if (client < 0) continue;
+            timeval timeout{2, 0};
+            ::setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+            ::setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+            char request[1024];
+            (void)::recv(client, request, sizeof(request), 0);   // path is ignored
+            const std::string body = Tracer::instance().prometheus();
+            const std::string response = "HTTP/1.1 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: " +
+                                         std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+            (void)::send(client, response.data(), response.size(), MSG_NOSIGNAL);
+            ::close(client);
+        }
+    }
+
+    int fd_ = -1;
+    std::atomic<bool> stopping_{false};
+    std::thread thread_;
+};
+
+// One traced YOLOv10n detection (same steps as 10.Ort_Detect_YOLOv10n.cpp)
+int detectOnce(Ort::Session& session, const char* input_name, const char* output_name,
+               const std::string& image_path, const std::string& output_path) {
+    cv::Mat image;
+    {
+        ScopedTimer t(Stage::ImRead);
+        image = cv::imread(image_path);
+    }
+    if (image.empty()) throw std::runtime_error("could not load image at " + image_path);
+
+    const int input_w = 640, input_h = 640;
+    std::vector<float> input_values(3 * input_w * input_h);
+    {
+        ScopedTimer t(Stage::Preprocess);
+        cv::Mat resized;
+        cv::resize(image, resized, cv::Size(input_w, input_h));
+        resized.convertTo(resized, CV_32F, 1.0 / 255.0);
+        std::vector<cv::Mat> channels = {
+            cv::Mat(input_h, input_w, CV_32F, input_values.data()),
+            cv::Mat(input_h, input_w, CV_32F, input_values.data() + input_w * input_h),
+            cv::Mat(input_h, input_w, CV_32F, input_values.data() + 2 * input_w * input_h)};
+        cv::split(resized, channels);
+    }
+
+    std::vector<int64_t> input_shape = {1, 3, input_h, input_w};
+    Ort::Value input_tensor{nullptr};
+    {
+        ScopedTimer t(Stage::TensorBuild);
+        Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+        input_tensor = Ort::Value::CreateTensor<float>(memory_info, input_values.data(), input_values.size(),
+                                                       input_shape.data(), input_shape.size());
+    }
+
+    std::vector<Ort::Value> outputs;
+    {
+        ScopedTimer t(Stage::Run);
+        outputs = session.Run(Ort::RunOptions{nullptr}, &input_name, &input_tensor, 1, &output_name, 1);
+    }
+
+    int detections = 0;
+    {
+        ScopedTimer t(Stage::Postprocess);
+        const float* data = outputs[0].GetTensorData<float>();
+        auto shape = outputs[0].GetTensorTypeAndShapeInfo().GetShape();
+        const float sx = static_cast<float>(image.cols) / input_w, sy = static_cast<float>(image.rows) / input_h;
+        for (int64_t i = 0; i < shape[1]; i++) {
+            const float* d = data + i * shape[2];
+            if (d[4] < 0.25f) continue;
+            cv::rectangle(image, cv::Rect(int(d[0] * sx), int(d[1] * sy), int((d[2] - d[0]) * sx), int((d[3] - d[1]) * sy)),
+                          cv::Scalar(0, 255, 0), 2);
+            detections++;
+        }
+    }
+
+    {
+        ScopedTimer t(Stage::ImWrite);
+        cv::imwrite(output_path, image);
+    }
+    return detections;
+}
+
+// Cost of an empty timed scope, in ns
+double scopeCostNs(int iterations) {
+    auto t0 = Clock::now();
+    for (int i = 0; i < iterations; i++) {
+        ScopedTimer t(Stage::Postprocess);
+        std::atomic_signal_fence(std::memory_order_seq_cst);   // keep the loop from being removed
+    }
+    return std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / iterations;
+}
+
+// ---------------- Main ----------------
+int main(int argc, char** argv) {
+    try {
+        std::cout << "--- Per-Stage Tracing (Prometheus / JSON) Demo ---" << std::endl;
+
+        int iterations = 50, port = 0;
+        bool serve_all = false;
+        for (int i = 1; i < argc; i++) {
+            if (std::strcmp(argv[i], "--serve") == 0 && i + 1 < argc) port = std::atoi(argv[++i]);
+            else if (std::strcmp(argv[i], "--serve-all") == 0) serve_all = true;
+            else iterations = std::max(1, std::atoi(argv[i]));
+        }
+
+        Tracer& tracer = Tracer::instance();
+
+        // 1. Overhead of the instrumentation itself
+        const int scope_iterations = 10000000;
+        tracer.setEnabled(false);
+        const double off_ns = scopeCostNs(scope_iterations);
+        tracer.setEnabled(true);
+        const double on_ns = scopeCostNs(scope_iterations);
+        std::printf("Empty timed scope: %.2f ns disabled, %.2f ns enabled\n", off_ns, on_ns);
+
+        // Drop the overhead samples so they do not pollute the postprocess stage
+        tracer.setEnabled(false);
+        tracer.reset();
+
+        Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "StageTracingDemo");
+        Ort::SessionOptions session_options;
+        session_options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+        session_options.SetIntraOpNumThreads(2);
+        Ort::Session session(env, "/assets/models/yolov10n.onnx", session_options);
+
+        Ort::AllocatorWithDefaultOptions allocator;
+        auto input_name = session.GetInputNameAllocated(0, allocator);
+        auto output_name = session.GetOutputNameAllocated(0, allocator);
+        const std::string image_path = "/assets/images/car.png";
+
+        std::unique_ptr<MetricsServer> server;
+        if (port > 0) server = std::make_unique<MetricsServer>(port, serve_all);
+
+        // 2. Traced detection loop on two threads (one Session is safe to Run concurrently)
+        detectOnce(session, input_name.get(), output_name.get(), image_path, "/assets/output/tracing_warmup.jpg");
+        tracer.setEnabled(true);
+        auto worker = [&](int id) {
+            const std::string out = "/assets/output/tracing_t" + std::to_string(id) + ".jpg";
+            for (int i = 0; i < iterations; i++) detectOnce(session, input_name.get(), output_name.get(), image_path, out);
+        };
+        // t1 must be joined on every path, and its own exception is handed back to this thread
+        std::exception_ptr t1_error;
+        std::thread t1([&] {
+            try {
+                worker(1);
+            } catch (...) {
+                t1_error = std::current_exception();
+            }
+        });
+        try {
+            worker(0);
+        } catch (...) {
+            t1.join();
+            throw;
+        }
+        t1.join();
+        if (t1_error) std::rethrow_exception(t1_error);
+
+        // 3. Export
+        std::printf("\n%-13s | %6s | %9s | %9s | %9s\n", "stage", "count", "p50 ms", "p90 ms", "p99 ms");
+        for (const auto& s : tracer.summarize()) {
+            std::printf("%-13s | %6llu | %9.3f | %9.3f | %9.3f\n", s.name.c_str(),
+                        static_cast<unsigned long long>(s.count), s.p50_ms, s.p90_ms, s.p99_ms);
+        }
+
+        const std::string prom = tracer.prometheus(), json = tracer.json();
+        std::cout << "\n" << prom << "\n" << json << std::endl;
+        std::ofstream("/assets/output/stage_metrics.prom") << prom;
+        std::ofstream("/assets/output/stage_metrics.json") << json << "\n";
+        std::cout << "Saved /assets/output/stage_metrics.prom and /assets/output/stage_metrics.json" << std::endl;
+
+        // Keep serving until interrupted
+        if (server && server->running()) {
+            std::cout << "Press Ctrl+C to stop serving." << std::endl;
+            server->wait();
+        }
+    }
+    catch (const Ort::Exception& e) {
+        std::cerr << "ONNX Runtime error: " << e.what() << std::endl;
+        return -1;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Standard exception: " << e.what() << std::endl;
+        return -1;
+    }
+
+    std::cout << "--- Demo Complete ---" << std::endl;
+    return 0;
+}
@@ -0,0 +1,420 @@
+/*
+
+Why do we need a profiling report?
+----------------------------------------------------
+03.Ort_SessionOptions.cpp calls session_options.EnableProfiling("profiling_output.json"), but nothing ever reads the file it
+produces. An ORT profile is a Chrome-trace JSON array with one event per kernel call, plus fence events and session events:
+
+    {"cat": "Session", "name": "session_initialization", "dur": 81234, ...}
+    {"cat": "Session", "name": "model_run", "ts": 90012, "dur": 1520, ...}
+    {"cat": "Node", "name": "Conv_0_kernel_time", "ts": 90100, "dur": 310,
+     "args": {"op_name": "Conv", "provider": "CPUExecutionProvider", ...}}
+
+A 100-run profile of a detection model has tens of thousands of such events, far too many to read by hand. This tool parses the
+file and aggregates it:
+
+    - Session init: model loading and session initialization events, reported separately from per-run cost.
+    - Runs: number of model_run events and average wall time per run. The first runs can be skipped (--skip N), because warm-up
+      runs allocate the arena and are slower. Kernel events are assigned to a run by their timestamp.
+    - Hotspots by op type + execution provider: node count, kernel time per run, share and cumulative share of kernel time.
+    - Hotspots by node: the individual nodes that dominate.
+    - By execution provider: how much of the time each EP spent (useful to spot CPU fallbacks next to CUDA/TensorRT).
+    - Diff: given two profiles, compare the per-run kernel time of each op type, sorted by absolute change. Times are
+      normalized per run, so profiles with different run counts can be compared.
+
+The JSON is read with a small recursive-descent parser, so there are no extra dependencies.
+
+Usage:
+    ./ort_profile_report                                   -> profile mnist.onnx (20 runs) and report it
+    ./ort_profile_report <profile.json> [--top N] [--skip N]
+    ./ort_profile_report <before.json> <after.json> [--top N] [--skip N]
+
+*/
+
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <map>
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <onnxruntime_cxx_api.h>
+
+// ---------------- Minimal JSON ----------------
+struct JsonValue {
+    enum class Type { Null, Bool, Number, String, Array, Object } type = Type::Null;
+    bool boolean = false;
+    double number = 0.0;
+    std::string str;
+    std::vector<JsonValue> array;
+    std::vector<std::pair<std::string, JsonValue>> object;
+
+    const JsonValue* get(const std::string& key) const {
+        for (const auto& kv : object) {
+            if (kv.first == key) return &kv.second;
+        }
+        return nullptr;
+    }
+    std::string getString(const std::string& key) const {
+        const JsonValue* v = get(key);
+        return v && v->type == Type::String ? v->str : std::string();
+    }
+    double getNumber(const std::string& key) const {
+        const JsonValue* v = get(key);
+        return v && v->type == Type::Number ? v->number : 0.0;
+    }
+};
+
+class JsonParser {
+public:
+    explicit JsonParser(const std::string& text) : s_(text) {}
+
+    JsonValue parse() {
+        JsonValue v = parseValue();
+        skipSpace();
+        if (pos_ != s_.size()) fail("trailing characters");
+        return v;
+    }
+
+private:
+    [[noreturn]] void fail(const std::string& what) const {
+        throw std::runtime_error("JSON parse error at offset " + std::to_string(pos_) + ": " + what);
+    }
+    void skipSpace() {
+        while (pos_ < s_.size() && std::isspace(static_cast<unsigned char>(s_[pos_]))) pos_++;
+    }
+    void expect(char c) {
+        skipSpace();
+        if (pos_ >= s_.size() || s_[pos_] != c) fail(std::string("expected '") + c + "'");
+        pos_++;
+    }
+    bool consume(char c) {
+        skipSpace();
+        if (pos_ < s_.size() && s_[pos_] == c) {
+            pos_++;
+            return true;
+        }
+        return false;
+    }
+
+    JsonValue parseValue() {
+        skipSpace();
+        if (pos_ >= s_.size()) fail("unexpected end");
+        JsonValue v;
+        const char c = s_[pos_];
+        if (c == '{') {
+            v.type = JsonValue::Type::Object;
+            pos_++;
+            if (consume('}')) return v;
+            do {
+                skipSpace();
+                std::string key = parseString();
+                expect(':');
+                v.object.emplace_back(std::move(key), parseValue());
+            } while (consume(','));
+            expect('}');
+        } else if (c == '[') {
+            v.type = JsonValue::Type::Array;
+            pos_++;
+            if (consume(']')) return v;
+            do {
+                v.array.push_back(parseValue());
+            } while (consume(','));
+            expect(']');
+        } else if (c == '"') {
+            v.type = JsonValue::Type::String;
+            v.str = parseString();
+        } else if (s_.compare(pos_, 4, "true") == 0 || s_.compare(pos_, 5, "false") == 0) {
+            v.type = JsonValue::Type::Bool;
+            v.boolean = s_[pos_] == 't';
+            pos_ += v.boolean ? 4 : 5;
+        } else if (s_.compare(pos_, 4, "null") == 0) {
+            pos_ += 4;
+        } else {
+            const char* begin = s_.c_str() + pos_;
+            char* end = nullptr;
+            v.type = JsonValue::Type::Number;
+            v.number = std::strtod(begin, &end);
+            if (end == begin) fail("invalid value");
+            pos_ += static_cast<size_t>(end - begin);
+        }
+        return v;
+    }
+
+    std::string parseString() {
+        if (pos_ >= s_.size() || s_[pos_] != '"') fail("expected string");
+        pos_++;
+        std::string out;
+        while (pos_ < s_.size() && s_[pos_] != '"') {
+            char c = s_[pos_++];
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (pos_ >= s_.size()) fail("bad escape");
+            char e = s_[pos_++];
+            switch (e) {
+                case 'n': out += '\n'; break;
+                case 't': out += '\t'; break;
+                case 'r': out += '\r'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'u': {
+                    if (pos_ + 4 > s_.size()) fail("bad \\u escape");
+                    unsigned code = static_cast<unsigned>(std::strtoul(s_.substr(pos_, 4).c_str(), nullptr, 16));
+                    pos_ += 4;
+                    out += code < 0x80 ? static_cast<char>(code) : '?';   // names in ORT profiles are ASCII
+                    break;
+                }
+                default: out += e; break;   // \" \\ \/
+            }
+        }
+        if (pos_ >= s_.size()) fail("unterminated string");
+        pos_++;
+        return out;
+    }
+
+    const std::string& s_;
+    size_t pos_ = 0;
+};
+
+// ---------------- Profile model ----------------
+struct KernelEvent {
+    std::string node, op, provider;
+    double ts = 0, dur = 0;   // microseconds
+};
+
+struct Profile {
+    std::vector<std::pair<std::string, double>> init_events;   // name, us
+    std::vector<std::pair<double, double>> runs;               // model_run ts, dur (us)
+    std::vector<KernelEvent> kernels;
+};
+
+Profile loadProfile(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("cannot open profile " + path);
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    const std::string text = buffer.str();
+    JsonValue root = JsonParser(text).parse();
+    if (root.type != JsonValue::Type::Array) throw std::runtime_error(path + " is not an ORT profile (expected a JSON array)");
+
+    const std::string suffix = "_kernel_time";
+    Profile profile;
+    for (const auto& e : root.array) {
+        const std::string cat = e.getString("cat"), name = e.getString("name");
+        const double dur = e.getNumber("dur");
+        if (cat == "Session") {
+            if (name == "model_run") profile.runs.emplace_back(e.getNumber("ts"), dur);
+            else if (name == "model_loading_uri" || name == "model_loading_array" || name == "session_initialization")
+                profile.init_events.emplace_back(name, dur);
+        } else if (cat == "Node" && name.size() > suffix.size() &&
+                   name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0) {
+            // Fence events only mark synchronization points; the kernel event carries the compute time
+            KernelEvent k;
+            k.node = name.substr(0, name.size() - suffix.size());
+            k.ts = e.getNumber("ts");
+            k.dur = dur;
+            if (const JsonValue* args = e.get("args")) {
+                k.op = args->getString("op_name");
+                k.provider = args->getString("provider");
+            }
+            if (k.op.empty()) k.op = "?";
+            if (k.provider.empty()) k.provider = "?";
+            profile.kernels.push_back(std::move(k));
+        }
+    }
+    std::sort(profile.runs.begin(), profile.runs.end());
+    return profile;
+}
+
+struct Aggregate {
+    std::string op, provider;
+    double total_us = 0;
+    long calls = 0;
+    int nodes = 0;
+};
+
+struct Summary {
+    int runs = 0, skipped = 0;
+    double run_us = 0;          // wall time per run
+    double kernel_us = 0;       // kernel time per run
+    std::map<std::string, Aggregate> by_op, by_node, by_provider;
+};
+
+// Aggregates runs [skip, end); kernels outside the kept runs (warm-up, init) are ignored when runs are known
+Summary summarize(const Profile& p, int skip) {
+    Summary s;
+    const int total_runs = static_cast<int>(p.runs.size());
+    skip = std::min(skip, std::max(0, total_runs - 1));
+    const double kept_from = total_runs > 0 ? p.runs[skip].first : 0.0;
+
+    for (int r = skip; r < total_runs; r++) s.run_us += p.runs[r].second;
+    s.skipped = total_runs > 0 ? skip : 0;
+    s.runs = std::max(1, total_runs - s.skipped);
+    s.run_us /= s.runs;
+
+    std::map<std::string, std::map<std::string, bool>> op_nodes;
+    for (const auto& k : p.kernels) {
+        if (total_runs > 0 && k.ts < kept_from) continue;
+        const std::string op_key = k.op + " @ " + k.provider;
+        Aggregate& op = s.by_op[op_key];
+        op.op = k.op; op.provider = k.provider; op.total_us += k.dur; op.calls++;
+        op_nodes[op_key][k.node] = true;
+
+        Aggregate& node = s.by_node[k.node];
+        node.op = k.op; node.provider = k.provider; node.total_us += k.dur; node.calls++;
+
+        Aggregate& ep = s.by_provider[k.provider];
+        ep.provider = k.provider; ep.total_us += k.dur; ep.calls++;
+
+        s.kernel_us += k.dur;
+    }
+    for (auto& kv : s.by_op) kv.second.nodes = static_cast<int>(op_nodes[kv.first].size());
+    s.kernel_us /= s.runs;
+    return s;
+}
+
+std::vector<std::pair<std::string, Aggregate>> ranked(const std::map<std::string, Aggregate>& m) {
+    std::vector<std::pair<std::string, Aggregate>> v(m.begin(), m.end());
+    std::sort(v.begin(), v.end(), [](const auto& a, const auto& b) { return a.second.total_us > b.second.total_us; });
+    return v;
+}
+
+void printReport(const std::string& path, const Profile& p, const Summary& s, int top) {
+    std::printf("\n=== %s ===\n", path.c_str());
+    for (const auto& e : p.init_events) std::printf("init  %-24s %10.2f ms\n", e.first.c_str(), e.second / 1e3);
+    std::printf("runs  %d profiled, %d skipped as warm-up\n", static_cast<int>(p.runs.size()), s.skipped);
+    std::printf("per run: wall %.3f ms, kernels %.3f ms (%.0f%% of wall)\n",
+                s.run_us / 1e3, s.kernel_us / 1e3, s.run_us > 0 ? 100.0 * s.kernel_us / s.run_us : 0.0);
+
+    const double kernel_total = s.kernel_us * s.runs;
+    auto pct = [&](double us) { return kernel_total > 0 ? 100.0 * us / kernel_total : 0.0; };
+
+    std::printf("\nHotspots by op type\n%-28s | %-22s | %5s | %11s | %6s | %6s\n", "op", "provider", "nodes", "us / run", "%", "cum %");
+    double cum = 0;
+    int row = 0;
+    for (const auto& kv : ranked(s.by_op)) {
+        if (row++ >= top) break;
+        cum += pct(kv.second.total_us);
+        std::printf("%-28s | %-22s | %5d | %11.1f | %6.1f | %6.1f\n", kv.second.op.c_str(), kv.second.provider.c_str(),
+                    kv.second.nodes, kv.second.total_us / s.runs, pct(kv.second.total_us), cum);
+    }
+
+    std::printf("\nHotspots by node\n%-40s | %-16s | %11s | %6s\n", "node", "op", "us / run", "%");
+    row = 0;
+    for (const auto& kv : ranked(s.by_node)) {
+        if (row++ >= top) break;
+        std::printf("%-40s | %-16s | %11.1f | %6.1f\n", kv.first.substr(0, 40).c_str(), kv.second.op.c_str(),
+                    kv.second.total_us / s.runs, pct(kv.second.total_us));
+    }
+
+    std::printf("\nBy execution provider\n%-28s | %11s | %6s\n", "provider", "us / run", "%");
+    for (const auto& kv : ranked(s.by_provider)) {
+        std::printf("%-28s | %11.1f | %6.1f\n", kv.first.c_str(), kv.second.total_us / s.runs, pct(kv.second.total_us));
+    }
+}
+
+void printDiff(const Summary& before, const Summary& after, int top) {
+    struct Row { std::string key; double a, b; };
+    std::vector<Row> rows;
+    for (const auto& kv : before.by_op) {
+        auto it = after.by_op.find(kv.first);
+        rows.push_back({kv.first, kv.second.total_us / before.runs, it == after.by_op.end() ? 0.0 : it->second.total_us / after.runs});
+    }
+    for (const auto& kv : after.by_op) {
+        if (!before.by_op.count(kv.first)) rows.push_back({kv.first, 0.0, kv.second.total_us / after.runs});
+    }
+    std::sort(rows.begin(), rows.end(), [](const Row& x, const Row& y) { return std::fabs(x.b - x.a) > std::fabs(y.b - y.a); });
+
+    std::printf("\n=== Diff (per run, before -> after) ===\n");
+    std::printf("%-40s | %11s | %11s | %11s | %7s\n", "op @ provider", "before us", "after us", "delta us", "ratio");
+    std::printf("%-40s | %11.1f | %11.1f | %+11.1f | %6.2fx\n", "[wall time per run]", before.run_us, after.run_us,
+                after.run_us - before.run_us, before.run_us > 0 ? after.run_us / before.run_us : 0.0);
+    int row = 0;
+    for (const auto& r : rows) {
+        if (row++ >= top) break;
+        char ratio[16];
+        if (r.a > 0) std::snprintf(ratio, sizeof(ratio), "%6.2fx", r.b / r.a);
+        else std::snprintf(ratio, sizeof(ratio), "%7s", "new");
+        std::printf("%-40s | %11.1f | %11.1f | %+11.1f | %s\n", r.key.substr(0, 40).c_str(), r.a, r.b, r.b - r.a, ratio);
+    }
+}
+
+// Profiles `runs` runs of a model with a synthetic input and returns the profile file name
+std::string generateProfile(const std::string& model_path, int runs) {
+    Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "ProfileReportDemo");
+    Ort::SessionOptions session_options;
+    session_options.SetIntraOpNumThreads(2);
+    session_options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_EXTENDED);
+    session_options.EnableProfiling("profiling_output");
+    Ort::Session session(env, model_path.c_str(), session_options);
+
+    Ort::AllocatorWithDefaultOptions allocator;
+    auto input_name = session.GetInputNameAllocated(0, allocator);
+    auto output_name = session.GetOutputNameAllocated(0, allocator);
+    const char* input_names[] = {input_name.get()};
+    const char* output_names[] = {output_name.get()};
+
+    std::vector<int64_t> shape = session.GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+    size_t count = 1;
+    for (auto& d : shape) {
+        if (d < 0) d = 1;
+        count *= static_cast<size_t>(d);
+    }
+    std::vector<float> data(count, 0.5f);
+    Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+    Ort::Value input = Ort::Value::CreateTensor<float>(memory_info, data.data(), data.size(), shape.data(), shape.size());
+    for (int i = 0; i < runs; i++) session.Run(Ort::RunOptions{nullptr}, input_names, &input, 1, output_names, 1);
+
+    // ORT appends a timestamp to the prefix; EndProfiling returns the actual file name
+    return session.EndProfilingAllocated(allocator).get();
+}
+
+// ---------------- Main ----------------
+int main(int argc, char** argv) {
+    try {
+        std::cout << "--- ORT Profiling Report ---" << std::endl;
+
+        std::vector<std::string> files;
+        int top = 15, skip = 1;
+        for (int i = 1; i < argc; i++) {
+            if (std::strcmp(argv[i], "--top") == 0 && i + 1 < argc) top = std::max(1, std::atoi(argv[++i]));
+            else if (std::strcmp(argv[i], "--skip") == 0 && i + 1 < argc) skip = std::max(0, std::atoi(argv[++i]));
+            else files.push_back(argv[i]);
+        }
+
+        if (files.empty()) {
+            const std::string model_path = "/assets/models/mnist.onnx";
+            files.push_back(generateProfile(model_path, 20));
+            std::cout << "Profiled " << model_path << " -> " << files[0] << std::endl;
+        }
+        if (files.size() > 2) throw std::runtime_error("expected one profile, or two profiles to diff");
+
+        std::vector<Summary> summaries;
+        for (const auto& path : files) {
+            Profile profile = loadProfile(path);
+            summaries.push_back(summarize(profile, skip));
+            printReport(path, profile, summaries.back(), top);
+        }
+        if (summaries.size() == 2) printDiff(summaries[0], summaries[1], top);
+    }
+    catch (const Ort::Exception& e) {
+        std::cerr << "ONNX Runtime error: " << e.what() << std::endl;
+        return -1;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Standard exception: " << e.what() << std::endl;
+        return -1;
+    }
+
+    std::cout << "--- Report Complete ---" << std::endl;
+    return 0;
+}
@@ -0,0 +1,351 @@
+/*
+
+Why do we need tiled inference?
+----------------------------------------------------
+10.Ort_Detect_YOLOv10n.cpp squeezes every image to 640x640 with cv::resize. A 3840x2160 (4K) camera frame is then downscaled 6x
+horizontally and 3.4x vertically: a 30-pixel-wide person becomes 5 pixels wide and is no longer detectable, and the aspect ratio
+is distorted.
+
+Tiled (sliced) inference keeps the native resolution instead:
+
+    1. Cut the image into tile x tile crops (default 640) with `overlap` pixels of overlap, so every object of up to
+       `overlap` pixels fits whole in at least one tile. The last row/column is aligned to the image border, and images
+       smaller than a tile are padded with gray (114), like the Ultralytics letterbox. If the model input is fixed (yolov10n
+       is 640x640) and differs from the tile size, each tile is resized to it and the boxes are scaled back.
+    2. Run the tiles in one of two ways:
+         - batch    : up to max_batch tiles per Run in a [B, 3, 640, 640] tensor. Needs a model exported with a dynamic
+                      batch axis (see 12.Ort_Detect_YOLOv10n_Batched.cpp).
+         - parallel : a pool of sessions (each with hw / sessions intra-op threads); worker threads take the next tile
+                      from an atomic counter.
+    3. Shift each tile's detections by the tile origin into global coordinates.
+    4. Merge duplicates across tile borders. An object cut by a border yields a partial box in one tile and a full box in
+       the neighbour. IoU between the two is low, but intersection-over-smaller (IoS) is high. Same-class boxes with
+       IoS > merge_threshold are therefore merged into their union, keeping the higher score (greedy non-maximum merging).
+
+The demo compares the plain resize baseline, batched tiles and parallel tiles. It reports tiles, latency, throughput in
+megapixels/s and detections, and saves the tiled result. A small input image is upscaled to 3840x2160 so that it behaves like a
+4K frame.
+
+Usage:
+    ./ort_tiled_inference [model.onnx] [image] [tile] [overlap] [sessions]
+
+*/
+
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <algorithm>
+#include <exception>
+#include <cstdio>
+#include <cstdlib>
+#include <onnxruntime_cxx_api.h>
+#include <opencv2/opencv.hpp>
+
+using Clock = std::chrono::steady_clock;
+
+struct TilingConfig {
+    int tile = 640;
+    int overlap = 128;             // pixels shared by neighbouring tiles
+    int max_batch = 8;             // tiles per Run in batch mode
+    float conf_threshold = 0.25f;
+    float merge_threshold = 0.5f;  // IoS above which same-class boxes are merged
+};
+
+struct Detection {
+    float x1, y1, x2, y2, score;
+    int class_id;
+};
+
+// Tile origins along one axis: stride = tile - overlap, last tile aligned to the border
+std::vector<int> tileOrigins(int length, int tile, int overlap) {
+    std::vector<int> origins;
+    if (length <= tile) return {0};
+    const int stride = std::max(1, tile - overlap);
+    for (int pos = 0;; pos += stride) {
+        if (pos + tile >= length) {
+            origins.push_back(length - tile);
+            break;
+        }
+        origins.push_back(pos);
+    }
+    return origins;
+}
+
+std::vector<cv::Rect> computeTiles(int width, int height, const TilingConfig& cfg) {
+    std::vector<cv::Rect> tiles;
+    for (int y : tileOrigins(height, cfg.tile, cfg.overlap)) {
+        for (int x : tileOrigins(width, cfg.tile, cfg.overlap)) {
+            tiles.emplace_back(x, y, std::min(cfg.tile, width - x), std::min(cfg.tile, height - y));
+        }
+    }
+    return tiles;
+}
+
+// BGR uint8 image already at model size -> float CHW written straight into dst
+void toCHW(const cv::Mat& bgr, float* dst) {
+    cv::Mat float_img;
+    bgr.convertTo(float_img, CV_32F, 1.0 / 255.0);
+    const size_t plane = static_cast<size_t>(bgr.cols) * bgr.rows;
+    std::vector<cv::Mat> channels = {
+        cv::Mat(bgr.rows, bgr.cols, CV_32F, dst),
+        cv::Mat(bgr.rows, bgr.cols, CV_32F, dst + plane),
+        cv::Mat(bgr.rows, bgr.cols, CV_32F, dst + 2 * plane)};
+    cv::split(float_img, channels);
+}
+
+// Crop (padded to tile x tile, then resized to the net_w x net_h model input if they differ) -> float CHW written into dst
+void tileInto(const cv::Mat& image, const cv::Rect& roi, int tile, int net_w, int net_h, float* dst) {
+    cv::Mat crop = image(roi);
+    if (roi.width < tile || roi.height < tile) {
+        cv::Mat padded;
+        cv::copyMakeBorder(crop, padded, 0, tile - roi.height, 0, tile - roi.width, cv::BORDER_CONSTANT, cv::Scalar(114, 114, 114));
+        crop = padded;
+    }
+    if (crop.cols != net_w || crop.rows != net_h) {
+        cv::Mat resized;
+        cv::resize(crop, resized, cv::Size(net_w, net_h));
+        crop = resized;
+    }
+    toCHW(crop, dst);
+}
+
+// [B, N, 6] YOLOv10 output -> detections, shifted by each tile's origin (and scaled, for the resize baseline)
+void collect(const Ort::Value& output, const std::vector<cv::Rect>& origins, float sx, float sy,
+             float conf_threshold, std::vector<Detection>& out) {
+    const float* data = output.GetTensorData<float>();
+    auto shape = output.GetTensorTypeAndShapeInfo().GetShape();
+    const int64_t rows = shape[1], attrs = shape[2];
+    for (size_t b = 0; b < origins.size(); b++) {
+        const float* det = data + b * rows * attrs;
+        for (int64_t i = 0; i < rows; i++, det += attrs) {
+            if (det[4] < conf_threshold) continue;
+            const float ox = static_cast<float>(origins[b].x), oy = static_cast<float>(origins[b].y);
+            out.push_back({ox + det[0] * sx, oy + det[1] * sy, ox + det[2] * sx, oy + det[3] * sy, det[4], static_cast<int>(det[5])});
+        }
+    }
+}
+
+// Greedy non-maximum merging with intersection-over-smaller, per class
+std::vector<Detection> mergeAcrossTiles(std::vector<Detection> dets, float merge_threshold) {
+    std::sort(dets.begin(), dets.end(), [](const Detection& a, const Detection& b) { return a.score > b.score; });
+    std::vector<bool> merged(dets.size(), false);
+    std::vector<Detection> out;
+    for (size_t i = 0; i < dets.size(); i++) {
+        if (merged[i]) continue;
+        Detection keep = dets[i];
+        for (size_t j = i + 1; j < dets.size(); j++) {
+            if (merged[j] || dets[j].class_id != keep.class_id) continue;
+            const Detection& d = dets[j];
+            float iw = std::min(keep.x2, d.x2) - std::max(keep.x1, d.x1);
+            float ih = std::min(keep.y2, d.y2) - std::max(keep.y1, d.y1);
+            if (iw <= 0 || ih <= 0) continue;
+            float smaller = std::min((keep.x2 - keep.x1) * (keep.y2 - keep.y1), (d.x2 - d.x1) * (d.y2 - d.y1));
+            if (iw * ih > merge_threshold * smaller) {
+                keep.x1 = std::min(keep.x1, d.x1); keep.y1 = std::min(keep.y1, d.y1);
+                keep.x2 = std::max(keep.x2, d.x2); keep.y2 = std::max(keep.y2, d.y2);
+                merged[j] = true;
+            }
+        }
+        out.push_back(keep);
+    }
+    return out;
+}
+
+struct ModelIO {
+    std::string input_name, output_name;
+    bool dynamic_batch = false;
+    int net_w = 0, net_h = 0;      // model input size; tiles are resized to it when it differs from the tile size
+
+    size_t tileFloats() const { return 3 * static_cast<size_t>(net_w) * net_h; }
+};
+
+// Static H/W (yolov10n: 640x640) are used as is; dynamic ones follow the tile size
+ModelIO inspect(Ort::Session& session, int tile) {
+    Ort::AllocatorWithDefaultOptions allocator;
+    ModelIO io;
+    io.input_name = session.GetInputNameAllocated(0, allocator).get();
+    io.output_name = session.GetOutputNameAllocated(0, allocator).get();
+    const std::vector<int64_t> shape = session.GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+    io.dynamic_batch = shape[0] < 0;
+    io.net_h = shape.size() == 4 && shape[2] > 0 ? static_cast<int>(shape[2]) : tile;
+    io.net_w = shape.size() == 4 && shape[3] > 0 ? static_cast<int>(shape[3]) : tile;
+    return io;
+}
+
+Ort::Value runTiles(Ort::Session& session, const ModelIO& io, std::vector<float>& buffer, size_t count) {
+    std::vector<int64_t> shape = {static_cast<int64_t>(count), 3, io.net_h, io.net_w};
+    Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+    Ort::Value input = Ort::Value::CreateTensor<float>(memory_info, buffer.data(), count * io.tileFloats(), shape.data(), shape.size());
+    const char* input_names[] = {io.input_name.c_str()};
+    const char* output_names[] = {io.output_name.c_str()};
+    auto outputs = session.Run(Ort::RunOptions{nullptr}, input_names, &input, 1, output_names, 1);
+    return std::move(outputs[0]);
+}
+
+// Baseline of 10.Ort_Detect_YOLOv10n.cpp: squeeze the whole frame into one model input
+std::vector<Detection> detectResized(Ort::Session& session, const ModelIO& io, const cv::Mat& image, const TilingConfig& cfg) {
+    cv::Mat resized;
+    cv::resize(image, resized, cv::Size(io.net_w, io.net_h));
+    std::vector<float> buffer(io.tileFloats());
+    toCHW(resized, buffer.data());   // no square tile padding: a 640x384 model gets the whole frame in 640x384
+    Ort::Value output = runTiles(session, io, buffer, 1);
+    std::vector<Detection> dets;
+    collect(output, {cv::Rect(0, 0, 0, 0)}, static_cast<float>(image.cols) / io.net_w,
+            static_cast<float>(image.rows) / io.net_h, cfg.conf_threshold, dets);
+    return dets;
+}
+
+std::vector<Detection> detectTiledBatch(Ort::Session& session, const ModelIO& io, const cv::Mat& image,
+                                        const std::vector<cv::Rect>& tiles, const TilingConfig& cfg) {
+    const size_t tile_size = io.tileFloats();
+    const float sx = static_cast<float>(cfg.tile) / io.net_w, sy = static_cast<float>(cfg.tile) / io.net_h;
+    std::vector<float> buffer(cfg.max_batch * tile_size);
+    std::vector<Detection> dets;
+    for (size_t begin = 0; begin < tiles.size(); begin += cfg.max_batch) {
+        const size_t count = std::min<size_t>(cfg.max_batch, tiles.size() - begin);
+        for (size_t i = 0; i < count; i++) {
+            tileInto(image, tiles[begin + i], cfg.tile, io.net_w, io.net_h, buffer.data() + i * tile_size);
+        }
+        Ort::Value output = runTiles(session, io, buffer, count);
+        std::vector<cv::Rect> origins(tiles.begin() + begin, tiles.begin() + begin + count);
+        collect(output, origins, sx, sy, cfg.conf_threshold, dets);
+    }
+    return mergeAcrossTiles(std::move(dets), cfg.merge_threshold);
+}
+
+std::vector<Detection> detectTiledParallel(std::vector<std::unique_ptr<Ort::Session>>& sessions, const ModelIO& io,
+                                           const cv::Mat& image, const std::vector<cv::Rect>& tiles, const TilingConfig& cfg) {
+    std::atomic<size_t> next{0};
+    const float sx = static_cast<float>(cfg.tile) / io.net_w, sy = static_cast<float>(cfg.tile) / io.net_h;
+    std::vector<std::vector<Detection>> per_worker(sessions.size());
+    std::vector<std::exception_ptr> errors(sessions.size());
+    auto worker = [&](size_t w) {
+        try {
+            std::vector<float> buffer(io.tileFloats());
+            for (size_t t = next++; t < tiles.size(); t = next++) {
+                tileInto(image, tiles[t], cfg.tile, io.net_w, io.net_h, buffer.data());
+                Ort::Value output = runTiles(*sessions[w], io, buffer, 1);
+                collect(output, {tiles[t]}, sx, sy, cfg.conf_threshold, per_worker[w]);
+            }
+        } catch (...) {
+            errors[w] = std::current_exception();
+            next = tiles.size();   // let the other workers stop early
+        }
+    };
+    std::vector<std::thread> threads;
+    for (size_t w = 1; w < sessions.size(); w++) threads.emplace_back(worker, w);
+    worker(0);
+    for (auto& t : threads) t.join();
+    for (const auto& e : errors) {
+        if (e) std::rethrow_exception(e);
+    }
+
+    std::vector<Detection> dets;
+    for (auto& d : per_worker) dets.insert(dets.end(), d.begin(), d.end());
+    return mergeAcrossTiles(std::move(dets), cfg.merge_threshold);
+}
+
+template <typename Fn>
+double timeMs(Fn&& fn, int iterations) {
+    auto t0 = Clock::now();
+    for (int i = 0; i < iterations; i++) fn();
+    return std::chrono::duration<double, std::milli>(Clock::now() - t0).count() / iterations;
+}
+
+// ---------------- Main ----------------
+int main(int argc, char** argv) {
+    try {
+        std::cout << "--- Tiled Inference for High-Resolution Images Demo ---" << std::endl;
+
+        const std::string model_path = argc > 1 ? argv[1] : "/assets/models/yolov10n.onnx";
+        const std::string image_path = argc > 2 ? argv[2] : "/assets/images/car.png";
+        TilingConfig cfg;
+        if (argc > 3) cfg.tile = std::max(32, std::atoi(argv[3]));
+        if (argc > 4) cfg.overlap = std::max(0, std::min(cfg.tile - 1, std::atoi(argv[4])));
+        const int hw = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        const int num_sessions = argc > 5 ? std::max(1, std::atoi(argv[5])) : std::max(1, hw / 2);
+
+        cv::Mat image = cv::imread(image_path);
+        if (image.empty()) {
+            std::cerr << " Error: could not load image at " << image_path << std::endl;
+            return -1;
+        }
+        if (image.cols < 2 * cfg.tile && image.rows < 2 * cfg.tile) {
+            cv::resize(image, image, cv::Size(3840, 2160));   // behave like a 4K camera frame
+        }
+        const double megapixels = image.cols * static_cast<double>(image.rows) / 1e6;
+        const auto tiles = computeTiles(image.cols, image.rows, cfg);
+        std::printf("Image %dx%d (%.1f MP) | tile %d, overlap %d -> %zu tiles\n",
+                    image.cols, image.rows, megapixels, cfg.tile, cfg.overlap, tiles.size());
+
+        Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "TiledInferenceDemo");
+        Ort::SessionOptions batch_options;
+        batch_options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+        batch_options.SetIntraOpNumThreads(hw);
+        Ort::Session batch_session(env, model_path.c_str(), batch_options);
+        const ModelIO io = inspect(batch_session, cfg.tile);
+        if (io.net_w != cfg.tile || io.net_h != cfg.tile) {
+            std::printf("Model input is fixed at %dx%d: each %dx%d tile is resized to it and boxes are scaled back.\n",
+                        io.net_w, io.net_h, cfg.tile, cfg.tile);
+        }
+
+        // Session pool for parallel tiles; threads are split between sessions so they do not oversubscribe the CPU
+        Ort::SessionOptions pool_options;
+        pool_options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+        pool_options.SetIntraOpNumThreads(std::max(1, hw / num_sessions));
+        std::vector<std::unique_ptr<Ort::Session>> pool;
+        for (int i = 0; i < num_sessions; i++) pool.push_back(std::make_unique<Ort::Session>(env, model_path.c_str(), pool_options));
+
+        const int iterations = 5;
+        std::vector<Detection> dets;
+        std::printf("\n%-22s | %5s | %9s | %7s | %s\n", "mode", "tiles", "ms/frame", "MP/s", "detections");
+        auto report = [&](const char* mode, size_t n_tiles, double ms) {
+            std::printf("%-22s | %5zu | %9.1f | %7.1f | %zu\n", mode, n_tiles, ms, megapixels / (ms / 1e3), dets.size());
+        };
+
+        // 1. Baseline: whole frame resized to one tile
+        dets = detectResized(batch_session, io, image, cfg);
+        report("resize (baseline)", 1, timeMs([&] { dets = detectResized(batch_session, io, image, cfg); }, iterations));
+
+        // 2. Tiles in batches (dynamic batch axis only)
+        if (io.dynamic_batch) {
+            dets = detectTiledBatch(batch_session, io, image, tiles, cfg);
+            report("tiles, batched", tiles.size(),
+                   timeMs([&] { dets = detectTiledBatch(batch_session, io, image, tiles, cfg); }, iterations));
+        } else {
+            std::cout << "(batched mode skipped: the model has a fixed batch dimension; export with dynamic=True)" << std::endl;
+        }
+
+        // 3. Tiles across parallel sessions
+        dets = detectTiledParallel(pool, io, image, tiles, cfg);
+        const std::string label = "tiles, " + std::to_string(num_sessions) + " sessions";
+        report(label.c_str(), tiles.size(), timeMs([&] { dets = detectTiledParallel(pool, io, image, tiles, cfg); }, iterations));
+
+        // 4. Draw the tiled result
+        for (const auto& d : dets) {
+            cv::Rect box(static_cast<int>(d.x1), static_cast<int>(d.y1), static_cast<int>(d.x2 - d.x1), static_cast<int>(d.y2 - d.y1));
+            cv::rectangle(image, box, cv::Scalar(0, 255, 0), 2);
+            cv::putText(image, "cls " + std::to_string(d.class_id) + ":" + cv::format("%.2f", d.score),
+                        cv::Point(box.x, box.y - 5), cv::FONT_HERSHEY_SIMPLEX, 0.5, cv::Scalar(255, 0, 0), 1);
+        }
+        const std::string output_path = "/assets/output/tiled_output.jpg";
+        cv::imwrite(output_path, image);
+        std::cout << "Saved " << output_path << std::endl;
+    }
+    catch (const Ort::Exception& e) {
+        std::cerr << "ONNX Runtime error: " << e.what() << std::endl;
+        return -1;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Standard exception: " << e.what() << std::endl;
+        return -1;
+    }
+
+    std::cout << "--- Demo Complete ---" << std::endl;
+    return 0;
+}
@@ -0,0 +1,261 @@
+/*
+
+Why do we need shape buckets?
+----------------------------------------------------
+The YOLOv10 examples always run at input_w = 640, input_h = 640. A 160x120 thumbnail is upsampled 4x and then costs as much as a
+4K frame. A 1920x1080 frame is letterboxed into 640x640, so 44% of the tensor is gray padding, and the convolutions process it
+anyway. Conv FLOPs grow linearly with the number of input pixels, so this padding and upsampling is wasted work.
+
+BucketedDetector keeps a small set of input resolutions ("buckets"), all multiples of the stride (32):
+
+    320x320, 480x480, 640x640, 640x384 (landscape), 384x640 (portrait)
+
+    - One session per bucket. With a dynamic-shape export (dynamic=True), each session fixes the symbolic dimensions with
+      AddFreeDimensionOverrideByName (batch=1, height, width). ORT then plans memory for a static shape, just like a model
+      exported at that size. Each session is warmed up with one Run at creation time.
+    - Routing picks the smallest bucket that keeps the required quality. The reference is the scale the 640x640 letterbox
+      would use, never above 1.0 (upsampling adds no detail):
+          required = quality * min(1, 640 / max(w, h))
+          bucket scale = min(bucket_w / w, bucket_h / h)
+      Among the buckets with bucket scale >= required, the one with the fewest pixels wins. quality = 1.0 means "at least
+      as many source pixels as the 640 baseline"; lower values trade accuracy for speed.
+    - Boxes are mapped back through the letterbox (scale + padding) of the chosen bucket.
+
+If the model has a fixed input shape, only the bucket that matches it is kept. Export one model per size or use dynamic=True to
+get the savings.
+
+The demo builds a mixed-size image set from car.png (thumbnails, VGA, 720p, 1080p landscape/portrait, 4K). For each image it
+reports the chosen bucket and latency against the 640 baseline, plus the total GFLOPs and latency savings. GFLOPs are
+estimated as 6.7 GFLOPs (YOLOv10-N at 640x640) scaled by the pixel count.
+
+Usage:
+    ./ort_shape_buckets [model.onnx] [image] [quality]
+
+*/
+
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <memory>
+#include <tuple>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdio>
+#include <cstdlib>
+#include <onnxruntime_cxx_api.h>
+#include <opencv2/opencv.hpp>
+
+using Clock = std::chrono::steady_clock;
+
+constexpr double kGflopsAt640 = 6.7;   // YOLOv10-N, 640x640
+
+struct Bucket {
+    int width, height;
+    std::unique_ptr<Ort::Session> session;
+
+    double gflops() const { return kGflopsAt640 * width * height / (640.0 * 640.0); }
+    std::string name() const { return std::to_string(width) + "x" + std::to_string(height); }
+};
+
+struct LetterboxInfo {
+    float scale;
+    int pad_x, pad_y;
+};
+
+struct Detection {
+    cv::Rect box;
+    float score;
+    int class_id;
+};
+
+class BucketedDetector {
+public:
+    BucketedDetector(Ort::Env& env, const std::string& model_path, const std::vector<std::pair<int, int>>& shapes, float quality)
+        : quality_(quality) {
+        // Inspect the model once: symbolic names of the batch / height / width dimensions, or its fixed size
+        Ort::SessionOptions probe_options;
+        Ort::Session probe(env, model_path.c_str(), probe_options);
+        // type_info owns the shape info and the symbol strings, so it must outlive their use in the loop below
+        Ort::TypeInfo type_info = probe.GetInputTypeInfo(0);
+        auto info = type_info.GetTensorTypeAndShapeInfo();
+        const std::vector<int64_t> dims = info.GetShape();
+        const std::vector<const char*> symbols = info.GetSymbolicDimensions();
+        const bool dynamic_hw = dims.size() == 4 && symbols.size() == 4 && dims[2] < 0 && dims[3] < 0;
+
+        Ort::AllocatorWithDefaultOptions allocator;
+        input_name_ = probe.GetInputNameAllocated(0, allocator).get();
+        output_name_ = probe.GetOutputNameAllocated(0, allocator).get();
+
+        for (const auto& shape : shapes) {
+            if (!dynamic_hw && (shape.first != dims[3] || shape.second != dims[2])) continue;
+
+            Ort::SessionOptions session_options;
+            session_options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+            session_options.SetIntraOpNumThreads(4);
+            if (dynamic_hw) {
+                // Specialize the session to this bucket, so shapes are static and memory can be planned ahead
+                if (dims[0] < 0 && symbols[0][0] != '\0') session_options.AddFreeDimensionOverrideByName(symbols[0], 1);
+                if (symbols[2][0] != '\0') session_options.AddFreeDimensionOverrideByName(symbols[2], shape.second);
+                if (symbols[3][0] != '\0') session_options.AddFreeDimensionOverrideByName(symbols[3], shape.first);
+            }
+
+            Bucket bucket{shape.first, shape.second,
+                          std::make_unique<Ort::Session>(env, model_path.c_str(), session_options)};
+            std::vector<float> buffer;
+            run(bucket, cv::Mat(shape.second, shape.first, CV_8UC3, cv::Scalar(114, 114, 114)), buffer);   // warm-up
+            buckets_.push_back(std::move(bucket));
+        }
+        if (buckets_.empty()) throw std::runtime_error("no bucket matches the model's fixed input shape");
+        std::sort(buckets_.begin(), buckets_.end(),
+                  [](const Bucket& a, const Bucket& b) { return a.width * a.height < b.width * b.height; });
+        if (!dynamic_hw) {
+            std::cout << "Model has a fixed " << dims[3] << "x" << dims[2] << " input; only that bucket is available "
+                      << "(export with dynamic=True for multi-resolution buckets)." << std::endl;
+        }
+    }
+
+    // Smallest bucket whose letterbox scale keeps the required quality
+    const Bucket& route(int w, int h) const {
+        const double required = quality_ * std::min(1.0, 640.0 / std::max(w, h));
+        for (const auto& b : buckets_) {
+            if (std::min(static_cast<double>(b.width) / w, static_cast<double>(b.height) / h) >= required - 1e-9) return b;
+        }
+        return buckets_.back();
+    }
+
+    const Bucket& largest() const { return buckets_.back(); }
+    const std::vector<Bucket>& buckets() const { return buckets_; }
+
+    std::vector<Detection> detect(const cv::Mat& image, const Bucket& bucket) {
+        return run(bucket, image, buffer_);
+    }
+
+private:
+    // Letterbox (centered, gray 114) into the bucket, run it and map boxes back to the image
+    std::vector<Detection> run(const Bucket& bucket, const cv::Mat& image, std::vector<float>& buffer) {
+        LetterboxInfo lb;
+        lb.scale = std::min(static_cast<float>(bucket.width) / image.cols, static_cast<float>(bucket.height) / image.rows);
+        const int new_w = std::min(bucket.width, static_cast<int>(image.cols * lb.scale + 0.5f));
+        const int new_h = std::min(bucket.height, static_cast<int>(image.rows * lb.scale + 0.5f));
+        lb.pad_x = (bucket.width - new_w) / 2;
+        lb.pad_y = (bucket.height - new_h) / 2;
+
+        cv::Mat resized, padded;
+        cv::resize(image, resized, cv::Size(new_w, new_h));
+        cv::copyMakeBorder(resized, padded, lb.pad_y, bucket.height - new_h - lb.pad_y, lb.pad_x, bucket.width - new_w - lb.pad_x,
+                           cv::BORDER_CONSTANT, cv::Scalar(114, 114, 114));
+        padded.convertTo(padded, CV_32F, 1.0 / 255.0);
+
+        const size_t plane = static_cast<size_t>(bucket.width) * bucket.height;
+        buffer.resize(3 * plane);
+        std::vector<cv::Mat> channels = {
+            cv::Mat(bucket.height, bucket.width, CV_32F, buffer.data()),
+            cv::Mat(bucket.height, bucket.width, CV_32F, buffer.data() + plane),
+            cv::Mat(bucket.height, bucket.width, CV_32F, buffer.data() + 2 * plane)};
+        cv::split(padded, channels);
+
+        std::vector<int64_t> shape = {1, 3, bucket.height, bucket.width};
+        Ort::Value input = Ort::Value::CreateTensor<float>(memory_info_, buffer.data(), buffer.size(), shape.data(), shape.size());
+        const char* input_names[] = {input_name_.c_str()};
+        const char* output_names[] = {output_name_.c_str()};
+        auto outputs = bucket.session->Run(Ort::RunOptions{nullptr}, input_names, &input, 1, output_names, 1);
+
+        const float* data = outputs[0].GetTensorData<float>();
+        auto out_shape = outputs[0].GetTensorTypeAndShapeInfo().GetShape();
+        std::vector<Detection> dets;
+        for (int64_t i = 0; i < out_shape[1]; i++) {
+            const float* d = data + i * out_shape[2];
+            if (d[4] < 0.25f) continue;
+            const float x1 = (d[0] - lb.pad_x) / lb.scale, y1 = (d[1] - lb.pad_y) / lb.scale;
+            const float x2 = (d[2] - lb.pad_x) / lb.scale, y2 = (d[3] - lb.pad_y) / lb.scale;
+            dets.push_back({cv::Rect(static_cast<int>(x1), static_cast<int>(y1), static_cast<int>(x2 - x1), static_cast<int>(y2 - y1)),
+                            d[4], static_cast<int>(d[5])});
+        }
+        return dets;
+    }
+
+    float quality_;
+    std::vector<Bucket> buckets_;
+    std::string input_name_, output_name_;
+    std::vector<float> buffer_;
+    Ort::MemoryInfo memory_info_ = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+};
+
+template <typename Fn>
+double timeMs(Fn&& fn, int iterations) {
+    auto t0 = Clock::now();
+    for (int i = 0; i < iterations; i++) fn();
+    return std::chrono::duration<double, std::milli>(Clock::now() - t0).count() / iterations;
+}
+
+// ---------------- Main ----------------
+int main(int argc, char** argv) {
+    try {
+        std::cout << "--- Shape-Bucketed Multi-Resolution Sessions Demo ---" << std::endl;
+
+        const std::string model_path = argc > 1 ? argv[1] : "/assets/models/yolov10n.onnx";
+        const std::string image_path = argc > 2 ? argv[2] : "/assets/images/car.png";
+        const float quality = argc > 3 ? static_cast<float>(std::atof(argv[3])) : 1.0f;
+
+        cv::Mat source = cv::imread(image_path);
+        if (source.empty()) {
+            std::cerr << " Error: could not load image at " << image_path << std::endl;
+            return -1;
+        }
+
+        Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "ShapeBucketsDemo");
+        BucketedDetector detector(env, model_path, {{320, 320}, {480, 480}, {640, 640}, {640, 384}, {384, 640}}, quality);
+        std::cout << "Buckets:";
+        for (const auto& b : detector.buckets()) std::cout << " " << b.name();
+        std::cout << " | quality " << quality << std::endl;
+
+        // Mixed-size image set: (count, width, height)
+        const std::vector<std::tuple<int, int, int>> image_set = {
+            {20, 160, 120}, {20, 320, 240}, {10, 480, 480}, {10, 640, 480},
+            {10, 1280, 720}, {10, 1920, 1080}, {5, 1080, 1920}, {5, 3840, 2160}};
+
+        const Bucket& baseline = detector.largest();
+        const int iterations = 5;
+        double base_ms_total = 0, bucket_ms_total = 0, base_gflops = 0, bucket_gflops = 0;
+
+        std::printf("\n%-10s | %5s | %-8s | %11s | %10s | %9s | %s\n",
+                    "image", "count", "bucket", "baseline ms", "bucket ms", "GFLOPs", "detections (base/bucket)");
+        for (const auto& entry : image_set) {
+            const int count = std::get<0>(entry), w = std::get<1>(entry), h = std::get<2>(entry);
+            cv::Mat image;
+            cv::resize(source, image, cv::Size(w, h));
+            const Bucket& bucket = detector.route(w, h);
+
+            size_t base_dets = 0, bucket_dets = 0;
+            const double base_ms = timeMs([&] { base_dets = detector.detect(image, baseline).size(); }, iterations);
+            const double bucket_ms = timeMs([&] { bucket_dets = detector.detect(image, bucket).size(); }, iterations);
+
+            base_ms_total += count * base_ms;
+            bucket_ms_total += count * bucket_ms;
+            base_gflops += count * baseline.gflops();
+            bucket_gflops += count * bucket.gflops();
+
+            const std::string size = std::to_string(w) + "x" + std::to_string(h);
+            std::printf("%-10s | %5d | %-8s | %11.2f | %10.2f | %9.2f | %zu / %zu\n", size.c_str(), count, bucket.name().c_str(),
+                        base_ms, bucket_ms, bucket.gflops(), base_dets, bucket_dets);
+        }
+
+        std::printf("\nTotal GFLOPs : %.1f -> %.1f (%.1f%% saved)\n", base_gflops, bucket_gflops,
+                    100.0 * (1.0 - bucket_gflops / base_gflops));
+        std::printf("Total latency: %.1f ms -> %.1f ms (%.1f%% saved)\n", base_ms_total, bucket_ms_total,
+                    100.0 * (1.0 - bucket_ms_total / base_ms_total));
+    }
+    catch (const Ort::Exception& e) {
+        std::cerr << "ONNX Runtime error: " << e.what() << std::endl;
+        return -1;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Standard exception: " << e.what() << std::endl;
+        return -1;
+    }
+
+    std::cout << "--- Demo Complete ---" << std::endl;
+    return 0;
+}
@@ -0,0 +1,260 @@
+/*
+
+Why do we need a warm-up phase?
+----------------------------------------------------
+05.Ort_Session.cpp creates a session and stops at "Inference would be run with session.Run(...)". The first real Run on a new
+session is much slower than the following ones, because it pays for work that ORT does lazily:
+
+    - kernel setup on first use (e.g. prepacking of weights, MLAS/oneDNN primitive creation)
+    - memory-pattern planning for the input shape seen for the first time
+    - growing the CPU arena from empty to its working size
+    - starting and waking up the intra-op thread pool
+
+Right after a deploy this turns into a p100 spike for the first requests on every replica. It is worse for each new input shape,
+because every shape has its own memory pattern.
+
+SessionPool runs a warm-up phase driven by a config file, before the process reports ready:
+
+    - For every session and every configured input shape, run `iterations` Runs with random data.
+    - Then mark the pool ready and call the readiness hook. The demo's hook writes a ready file, the way a Kubernetes
+      exec/readiness probe or a load-balancer health check would see it. isReady() can back an HTTP health endpoint.
+    - Traffic that arrives before readiness should be rejected or queued by the caller. The demo only checks the flag.
+
+To measure the effect, each mode runs in a forked child process, so process-wide lazy initialization (thread pools, kernel
+registries) is paid again in every mode:
+
+    - cold : sessions created, no warm-up, traffic starts immediately
+    - warm : sessions created, warm-up from the config, then traffic
+
+For each mode the demo reports session creation, warm-up time, the latency of the first request and the steady-state p50/p99.
+
+Config file (key=value; `shape` may repeat; only input 0 is shaped, the model is assumed to have a single float input):
+    model=/assets/models/mnist.onnx
+    sessions=2
+    intra_op_threads=1
+    shape=1,1,28,28
+    iterations=3
+    ready_file=/tmp/ort_ready
+
+Usage:
+    ./ort_warmup [warmup.cfg] [requests]
+
+*/
+
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <random>
+#include <memory>
+#include <atomic>
+#include <functional>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdio>
+#include <cstdlib>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <onnxruntime_cxx_api.h>
+
+using Clock = std::chrono::steady_clock;
+
+struct WarmupConfig {
+    std::string model_path = "/assets/models/mnist.onnx";
+    int sessions = 2;
+    int intra_op_threads = 1;
+    std::vector<std::vector<int64_t>> shapes;   // empty: the model's own input shape (dynamic dims -> 1)
+    int iterations = 3;
+    std::string ready_file = "/tmp/ort_ready";
+};
+
+std::vector<int64_t> parseShape(const std::string& text) {
+    std::vector<int64_t> shape;
+    std::stringstream ss(text);
+    std::string dim;
+    while (std::getline(ss, dim, ',')) shape.push_back(std::atoll(dim.c_str()));
+    return shape;
+}
+
+// Missing file or keys keep the defaults
+WarmupConfig loadWarmupConfig(const std::string& path) {
+    WarmupConfig cfg;
+    std::ifstream in(path);
+    if (!in) return cfg;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        auto eq = line.find('=');
+        if (eq == std::string::npos) continue;
+        std::string key = line.substr(0, eq), value = line.substr(eq + 1);
+
+        if (key == "model") cfg.model_path = value;
+        else if (key == "sessions") cfg.sessions = std::max(1, std::atoi(value.c_str()));
+        else if (key == "intra_op_threads") cfg.intra_op_threads = std::max(1, std::atoi(value.c_str()));
+        else if (key == "shape") cfg.shapes.push_back(parseShape(value));
+        else if (key == "iterations") cfg.iterations = std::max(0, std::atoi(value.c_str()));
+        else if (key == "ready_file") cfg.ready_file = value;
+    }
+    return cfg;
+}
+
+class SessionPool {
+public:
+    SessionPool(Ort::Env& env, const WarmupConfig& cfg) : cfg_(cfg) {
+        Ort::SessionOptions session_options;
+        session_options.SetIntraOpNumThreads(cfg.intra_op_threads);
+        session_options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+        for (int i = 0; i < cfg.sessions; i++) {
+            sessions_.push_back(std::make_unique<Ort::Session>(env, cfg.model_path.c_str(), session_options));
+        }
+
+        Ort::AllocatorWithDefaultOptions allocator;
+        input_name_ = sessions_[0]->GetInputNameAllocated(0, allocator).get();
+        output_name_ = sessions_[0]->GetOutputNameAllocated(0, allocator).get();
+        if (cfg_.shapes.empty()) {
+            auto shape = sessions_[0]->GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+            for (auto& d : shape) d = d < 0 ? 1 : d;
+            cfg_.shapes.push_back(shape);
+        }
+    }
+
+    void setReadinessHook(std::function<void()> hook) { on_ready_ = std::move(hook); }
+    bool isReady() const { return ready_.load(); }
+
+    // Runs every configured shape through every session, then reports ready
+    void warmUp() {
+        for (auto& session : sessions_) {
+            for (const auto& shape : cfg_.shapes) {
+                for (int i = 0; i < cfg_.iterations; i++) run(*session, shape);
+            }
+        }
+        markReady();
+    }
+
+    void markReady() {
+        ready_.store(true);
+        if (on_ready_) on_ready_();
+    }
+
+    // One request on session i, returns latency in ms
+    double request(size_t i, const std::vector<int64_t>& shape) {
+        auto t0 = Clock::now();
+        run(*sessions_[i % sessions_.size()], shape);
+        return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+    }
+
+    const std::vector<std::vector<int64_t>>& shapes() const { return cfg_.shapes; }
+    size_t size() const { return sessions_.size(); }
+
+private:
+    void run(Ort::Session& session, const std::vector<int64_t>& shape) {
+        size_t count = 1;
+        for (auto d : shape) count *= static_cast<size_t>(d);
+        std::vector<float> data(count);
+        std::uniform_real_distribution<float> dist(0.f, 1.f);
+        for (auto& v : data) v = dist(rng_);
+
+        Ort::Value input = Ort::Value::CreateTensor<float>(memory_info_, data.data(), data.size(), shape.data(), shape.size());
+        const char* input_names[] = {input_name_.c_str()};
+        const char* output_names[] = {output_name_.c_str()};
+        session.Run(Ort::RunOptions{nullptr}, input_names, &input, 1, output_names, 1);
+    }
+
+    WarmupConfig cfg_;
+    std::vector<std::unique_ptr<Ort::Session>> sessions_;
+    std::string input_name_, output_name_;
+    std::atomic<bool> ready_{false};
+    std::function<void()> on_ready_;
+    std::mt19937 rng_{123};
+    Ort::MemoryInfo memory_info_ = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+};
+
+double msSince(Clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+}
+
+double percentile(std::vector<double> v, double q) {
+    if (v.empty()) return 0.0;
+    std::sort(v.begin(), v.end());
+    return v[std::min(v.size() - 1, static_cast<size_t>(q * (v.size() - 1) + 0.5))];
+}
+
+// Child process: create the pool, optionally warm it up, then serve `requests` requests round-robin
+int runMode(bool warm, const WarmupConfig& cfg, int requests) {
+    std::remove(cfg.ready_file.c_str());
+    Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "WarmupDemo");
+
+    auto t0 = Clock::now();
+    SessionPool pool(env, cfg);
+    const double create_ms = msSince(t0);
+
+    pool.setReadinessHook([&cfg]() {
+        std::ofstream(cfg.ready_file) << "ready\n";
+    });
+
+    t0 = Clock::now();
+    if (warm) pool.warmUp();
+    else pool.markReady();   // cold: report ready immediately, as the examples do today
+    const double warmup_ms = msSince(t0);
+    if (!pool.isReady()) throw std::runtime_error("pool is not ready");
+
+    // Traffic: the first request of each session and shape is the one that pays lazy initialization
+    std::vector<double> first, steady;
+    for (int r = 0; r < requests; r++) {
+        const auto& shape = pool.shapes()[(r / pool.size()) % pool.shapes().size()];
+        const double ms = pool.request(r, shape);
+        if (static_cast<size_t>(r) < pool.size() * pool.shapes().size()) first.push_back(ms);
+        else steady.push_back(ms);
+    }
+
+    const double first_ms = first.empty() ? 0.0 : *std::max_element(first.begin(), first.end());
+    const double p50 = percentile(steady, 0.50);
+    std::printf("%-5s | %9.1f | %9.1f | %15.3f | %9.3f | %9.3f | %8.1fx\n", warm ? "warm" : "cold",
+                create_ms, warmup_ms, first_ms, p50, percentile(steady, 0.99), p50 > 0 ? first_ms / p50 : 0.0);
+    return 0;
+}
+
+// ---------------- Main ----------------
+int main(int argc, char** argv) {
+    std::cout << "--- Startup Warm-Up Demo ---" << std::endl;
+
+    const std::string config_path = argc > 1 ? argv[1] : "warmup.cfg";
+    const int requests = argc > 2 ? std::max(10, std::atoi(argv[2])) : 200;
+    const WarmupConfig cfg = loadWarmupConfig(config_path);
+
+    std::cout << "Config: " << config_path << " | model " << cfg.model_path << " | sessions " << cfg.sessions
+              << " | shapes " << (cfg.shapes.empty() ? 1 : cfg.shapes.size()) << " | iterations " << cfg.iterations << std::endl;
+    std::printf("\n%-5s | %9s | %9s | %15s | %9s | %9s | %s\n",
+                "mode", "create ms", "warmup ms", "first req ms", "p50 ms", "p99 ms", "first/p50");
+    std::cout.flush();
+
+    // Each mode in its own process, so neither benefits from the other's lazy initialization
+    for (bool warm : {false, true}) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            try {
+                std::exit(runMode(warm, cfg, requests));
+            }
+            catch (const Ort::Exception& e) {
+                std::cerr << "ONNX Runtime error: " << e.what() << std::endl;
+            }
+            catch (const std::exception& e) {
+                std::cerr << "Standard exception: " << e.what() << std::endl;
+            }
+            std::exit(1);
+        }
+        int status = 0;
+        waitpid(pid, &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            std::cerr << "Mode '" << (warm ? "warm" : "cold") << "' failed." << std::endl;
+            return -1;
+        }
+    }
+
+    std::cout << "\nReady file: " << cfg.ready_file << std::endl;
+    std::cout << "--- Demo Complete ---" << std::endl;
+    return 0;
+}
@@ -0,0 +1,216 @@
+/*
+
+Why do we need global thread pools and a shared arena?
+----------------------------------------------------
+02.Ort_Env.cpp creates a plain Ort::Env, and every session calls SetIntraOpNumThreads on its own. Each session therefore owns:
+
+    - an intra-op thread pool (and an inter-op pool in parallel mode), with threads that spin while they wait for work
+    - a CPU arena that grows to that session's peak and never shrinks
+
+With 16 models in one process on a 16-core machine this means 16 x 16 = 256 intra-op threads competing for 16 cores. The result is
+constant context switches and preemption in the middle of parallel sections, so tail latency explodes. There are also 16 arenas,
+each holding its own peak.
+
+The global mode shares these resources in the process:
+
+    Ort::ThreadingOptions tp;
+    tp.SetGlobalIntraOpNumThreads(cores);      // one intra-op pool for every session
+    tp.SetGlobalInterOpNumThreads(1);
+    tp.SetGlobalSpinControl(0);                 // idle workers sleep instead of spinning
+    tp.SetGlobalDenormalAsZero();
+    Ort::Env env(tp, ORT_LOGGING_LEVEL_WARNING, "...");
+
+    Ort::ArenaCfg arena_cfg(0, 1, -1, -1);     // default max, extend by the requested size
+    env.CreateAndRegisterAllocator(cpu_memory_info, arena_cfg);
+
+    session_options.DisablePerSessionThreads();                      // use the Env's pools
+    session_options.AddConfigEntry("session.use_env_allocators", "1");  // use the Env's arena
+
+The benchmark runs 1, 4 and 16 co-resident sessions of the same model. One client thread per session issues requests concurrently.
+It compares per-session pools/arenas (what the examples do today) with the global mode. Each configuration runs in a forked child,
+and reports:
+
+    - OS threads in the process (/proc/self/status)
+    - voluntary + involuntary context switches during the run (getrusage)
+    - p50 / p99 / max request latency
+    - RSS after the run
+
+Usage:
+    ./ort_global_threadpool [model.onnx] [requests per session]
+
+*/
+
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <memory>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdio>
+#include <cstdlib>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <onnxruntime_cxx_api.h>
+
+using Clock = std::chrono::steady_clock;
+
+double rssMB() {
+    std::ifstream statm("/proc/self/statm");
+    long pages_total = 0, pages_resident = 0;
+    statm >> pages_total >> pages_resident;
+    return pages_resident * static_cast<double>(sysconf(_SC_PAGESIZE)) / (1024.0 * 1024.0);
+}
+
+int threadCount() {
+    std::ifstream status("/proc/self/status");
+    std::string key;
+    while (status >> key) {
+        if (key == "Threads:") {
+            int n = 0;
+            status >> n;
+            return n;
+        }
+    }
+    return 0;
+}
+
+long contextSwitches() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_nvcsw + usage.ru_nivcsw;
+}
+
+// Env with global intra/inter-op pools and a shared CPU arena, or a plain Env
+std::unique_ptr<Ort::Env> createEnv(bool global, int cores) {
+    if (!global) return std::make_unique<Ort::Env>(ORT_LOGGING_LEVEL_WARNING, "PerSessionPools");
+
+    Ort::ThreadingOptions tp_options;
+    tp_options.SetGlobalIntraOpNumThreads(cores);
+    tp_options.SetGlobalInterOpNumThreads(1);
+    tp_options.SetGlobalSpinControl(0);
+    tp_options.SetGlobalDenormalAsZero();
+    auto env = std::make_unique<Ort::Env>(tp_options, ORT_LOGGING_LEVEL_WARNING, "GlobalPools");
+
+    // max_mem = 0 (default), extend strategy 1 = kSameAsRequested, defaults for chunk sizes
+    Ort::ArenaCfg arena_cfg(0, 1, -1, -1);
+    Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+    env->CreateAndRegisterAllocator(memory_info, arena_cfg);
+    return env;
+}
+
+Ort::SessionOptions createSessionOptions(bool global, int cores) {
+    Ort::SessionOptions session_options;
+    session_options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+    if (global) {
+        session_options.DisablePerSessionThreads();
+        session_options.AddConfigEntry("session.use_env_allocators", "1");
+    } else {
+        session_options.SetIntraOpNumThreads(cores);   // every session sized for the whole machine
+    }
+    return session_options;
+}
+
+double percentile(std::vector<double> v, double q) {
+    if (v.empty()) return 0.0;
+    std::sort(v.begin(), v.end());
+    return v[std::min(v.size() - 1, static_cast<size_t>(q * (v.size() - 1) + 0.5))];
+}
+
+// Child process: N sessions, one client thread per session
+int runConfig(bool global, int num_sessions, const std::string& model_path, int requests) {
+    const int cores = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    auto env = createEnv(global, cores);
+    Ort::SessionOptions session_options = createSessionOptions(global, cores);
+
+    std::vector<std::unique_ptr<Ort::Session>> sessions;
+    for (int i = 0; i < num_sessions; i++) {
+        sessions.push_back(std::make_unique<Ort::Session>(*env, model_path.c_str(), session_options));
+    }
+
+    Ort::AllocatorWithDefaultOptions allocator;
+    auto input_name = sessions[0]->GetInputNameAllocated(0, allocator);
+    auto output_name = sessions[0]->GetOutputNameAllocated(0, allocator);
+    const char* input_names[] = {input_name.get()};
+    const char* output_names[] = {output_name.get()};
+    std::vector<int64_t> shape = sessions[0]->GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+    size_t count = 1;
+    for (auto& d : shape) {
+        if (d < 0) d = 1;
+        count *= static_cast<size_t>(d);
+    }
+    Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+
+    std::vector<std::vector<double>> latencies(num_sessions);
+    auto client = [&](int id) {
+        std::vector<float> data(count, 0.5f);
+        Ort::Value input = Ort::Value::CreateTensor<float>(memory_info, data.data(), data.size(), shape.data(), shape.size());
+        sessions[id]->Run(Ort::RunOptions{nullptr}, input_names, &input, 1, output_names, 1);   // warm-up
+        for (int r = 0; r < requests; r++) {
+            auto t0 = Clock::now();
+            sessions[id]->Run(Ort::RunOptions{nullptr}, input_names, &input, 1, output_names, 1);
+            latencies[id].push_back(std::chrono::duration<double, std::milli>(Clock::now() - t0).count());
+        }
+    };
+
+    const long switches_before = contextSwitches();
+    std::vector<std::thread> clients;
+    for (int i = 0; i < num_sessions; i++) clients.emplace_back(client, i);
+    const int threads_during = threadCount();
+    for (auto& t : clients) t.join();
+    const long switches = contextSwitches() - switches_before;
+
+    std::vector<double> all;
+    for (const auto& l : latencies) all.insert(all.end(), l.begin(), l.end());
+    std::printf("%-11s | %8d | %7d | %12ld | %8.3f | %8.3f | %8.3f | %7.1f\n", global ? "global" : "per-session",
+                num_sessions, threads_during, switches, percentile(all, 0.50), percentile(all, 0.99),
+                *std::max_element(all.begin(), all.end()), rssMB());
+    return 0;
+}
+
+// ---------------- Main ----------------
+int main(int argc, char** argv) {
+    std::cout << "--- Global Thread Pools + Shared Arena Demo ---" << std::endl;
+
+    const std::string model_path = argc > 1 ? argv[1] : "/assets/models/mnist.onnx";
+    const int requests = argc > 2 ? std::max(1, std::atoi(argv[2])) : 200;
+    std::cout << "Model: " << model_path << " | cores: " << std::thread::hardware_concurrency()
+              << " | requests per session: " << requests << std::endl;
+
+    std::printf("\n%-11s | %8s | %7s | %12s | %8s | %8s | %8s | %7s\n",
+                "mode", "sessions", "threads", "ctx switches", "p50 ms", "p99 ms", "max ms", "RSS MB");
+    std::cout.flush();
+
+    // Each configuration in its own process, so thread counts and RSS are not inherited
+    for (int num_sessions : {1, 4, 16}) {
+        for (bool global : {false, true}) {
+            pid_t pid = fork();
+            if (pid == 0) {
+                try {
+                    std::exit(runConfig(global, num_sessions, model_path, requests));
+                }
+                catch (const Ort::Exception& e) {
+                    std::cerr << "ONNX Runtime error: " << e.what() << std::endl;
+                }
+                catch (const std::exception& e) {
+                    std::cerr << "Standard exception: " << e.what() << std::endl;
+                }
+                std::exit(1);
+            }
+            int status = 0;
+            waitpid(pid, &status, 0);
+            if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+                std::cerr << "Configuration (" << (global ? "global" : "per-session") << ", " << num_sessions
+                          << " sessions) failed." << std::endl;
+                return -1;
+            }
+        }
+    }
+
+    std::cout << "\n--- Demo Complete ---" << std::endl;
+    return 0;
+}
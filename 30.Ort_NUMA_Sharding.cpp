@@ -0,0 +1,391 @@
+/*
+
+Why do we need NUMA-aware sharding?
+----------------------------------------------------
+08.Ort_Session_Run.cpp runs MNIST on one session with default thread placement. On a dual-socket server the OS can put the
+intra-op workers of one Run on both sockets, and can move them between sockets later. Each parallel section then reads
+weights and activations across the socket interconnect, with higher latency and lower bandwidth, and the threads of one Run
+wait for the slowest (remote) worker.
+
+ShardedRuntime splits the machine into core groups (one per NUMA node, or simulated groups on a single-socket box) and runs one
+session replica per group:
+
+    - Pinning: the shard's worker thread is pinned to its group (pthread_setaffinity_np). Its intra-op threads are pinned one
+      per core with the session config "session.intra_op_thread_affinities". That value holds one entry per extra thread
+      (intra_op_num_threads - 1, because the calling thread is thread 0), separated by ';'. Processor ids are 1-based:
+          "3;4;5" -> threads 1..3 on logical CPUs 2, 3, 4
+    - Local memory: the worker thread creates its session and input buffers after it has been pinned. With Linux' default
+      first-touch policy, the replica's weights, arena and buffers are then allocated on the group's own node, so libnuma is
+      not needed.
+    - Dispatch: each shard has its own request deque. Requests are spread by a hint (round-robin, hash, ...). A worker takes
+      work from the front of its own deque. When that is empty it steals from the back of the most loaded other deque,
+      preferring shards on the same NUMA node. Uneven shards (hot keys, bursts, smaller groups) therefore do not leave cores
+      idle.
+
+Topology comes from /sys/devices/system/node/node<N>/cpulist, restricted to the CPUs this process may use. With --groups G, or when
+the machine has a single node, the CPUs are split into G simulated groups, so the code paths can be tested on a laptop.
+
+The demo sends MNIST requests with a skewed distribution (60% to shard 0) with and without work stealing. It reports throughput,
+p50/p99 latency and the requests executed and stolen per shard.
+
+Usage:
+    ./ort_numa_sharding [--groups G] [requests] [model.onnx]
+
+*/
+
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <deque>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+#include <pthread.h>
+#include <sched.h>
+#include <onnxruntime_cxx_api.h>
+
+using Clock = std::chrono::steady_clock;
+
+struct CoreGroup {
+    int id;
+    int numa_node;
+    std::vector<int> cpus;
+};
+
+// "0-3,8-11" -> {0,1,2,3,8,9,10,11}
+std::vector<int> parseCpuList(const std::string& text) {
+    std::vector<int> cpus;
+    std::stringstream ss(text);
+    std::string part;
+    while (std::getline(ss, part, ',')) {
+        if (part.empty() || part == "\n") continue;
+        auto dash = part.find('-');
+        int first = std::atoi(part.c_str());
+        int last = dash == std::string::npos ? first : std::atoi(part.c_str() + dash + 1);
+        for (int c = first; c <= last; c++) cpus.push_back(c);
+    }
+    return cpus;
+}
+
+std::vector<int> allowedCpus() {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    sched_getaffinity(0, sizeof(set), &set);
+    std::vector<int> cpus;
+    for (int c = 0; c < CPU_SETSIZE; c++) {
+        if (CPU_ISSET(c, &set)) cpus.push_back(c);
+    }
+    return cpus;
+}
+
+// One group per NUMA node; or `simulate` groups cut from the allowed CPUs
+std::vector<CoreGroup> detectCoreGroups(int simulate) {
+    const std::vector<int> allowed = allowedCpus();
+    std::vector<CoreGroup> groups;
+
+    if (simulate <= 0) {
+        for (int node = 0;; node++) {
+            std::ifstream in("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+            if (!in) break;
+            std::string list;
+            std::getline(in, list);
+            CoreGroup g{static_cast<int>(groups.size()), node, {}};
+            for (int c : parseCpuList(list)) {
+                if (std::find(allowed.begin(), allowed.end(), c) != allowed.end()) g.cpus.push_back(c);
+            }
+            if (!g.cpus.empty()) groups.push_back(g);
+        }
+        if (groups.size() > 1) return groups;
+        simulate = std::max(2, static_cast<int>(allowed.size()) / 4);   // single node: simulate groups of ~4 cores
+        groups.clear();
+    }
+
+    simulate = std::min<int>(simulate, static_cast<int>(allowed.size()));
+    for (int g = 0; g < simulate; g++) {
+        CoreGroup group{g, 0, {}};
+        for (size_t i = g * allowed.size() / simulate; i < (g + 1) * allowed.size() / simulate; i++) group.cpus.push_back(allowed[i]);
+        groups.push_back(group);
+    }
+    return groups;
+}
+
+// Affinities for intra-op threads 1..n-1, one core each, 1-based processor ids
+std::string affinityString(const std::vector<int>& cpus) {
+    std::string s;
+    for (size_t i = 1; i < cpus.size(); i++) {
+        if (!s.empty()) s += ";";
+        s += std::to_string(cpus[i] + 1);
+    }
+    return s;
+}
+
+void pinCurrentThread(const std::vector<int>& cpus) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int c : cpus) CPU_SET(c, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+struct Response {
+    int digit;
+    int shard;
+    double latency_ms;
+};
+
+struct Request {
+    std::vector<float> input;
+    std::promise<Response> promise;
+    Clock::time_point enqueued;
+};
+
+class ShardedRuntime {
+public:
+    ShardedRuntime(Ort::Env& env, const std::string& model_path, std::vector<CoreGroup> groups, bool work_stealing)
+        : groups_(std::move(groups)), work_stealing_(work_stealing), shards_(groups_.size()) {
+        for (size_t i = 0; i < groups_.size(); i++) {
+            workers_.emplace_back(&ShardedRuntime::workerLoop, this, i, std::ref(env), model_path);
+        }
+        // Wait until every shard has created its session on its own cores
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return ready_count_ == groups_.size(); });
+        if (init_error_) {
+            lock.unlock();
+            shutdown();
+            std::rethrow_exception(init_error_);
+        }
+    }
+
+    ~ShardedRuntime() { shutdown(); }
+
+    std::future<Response> submit(std::vector<float> input, size_t shard_hint) {
+        auto request = std::make_unique<Request>();
+        request->input = std::move(input);
+        request->enqueued = Clock::now();
+        auto future = request->promise.get_future();
+
+        Shard& shard = shards_[shard_hint % shards_.size()];
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.queue.push_back(std::move(request));
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pending_++;
+        }
+        // Wake all workers: the target shard may be busy while another one is idle and can steal
+        cv_.notify_all();
+        return future;
+    }
+
+    void printStats() const {
+        for (size_t i = 0; i < shards_.size(); i++) {
+            std::printf("  shard %zu (node %d, %2zu cpus): executed %6ld, stolen %6ld\n", i, groups_[i].numa_node,
+                        groups_[i].cpus.size(), shards_[i].executed.load(), shards_[i].stolen.load());
+        }
+    }
+
+private:
+    struct Shard {
+        std::mutex mutex;
+        std::deque<std::unique_ptr<Request>> queue;
+        std::atomic<long> executed{0}, stolen{0};
+    };
+
+    std::unique_ptr<Request> popLocal(size_t i) {
+        Shard& shard = shards_[i];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (shard.queue.empty()) return nullptr;
+        auto request = std::move(shard.queue.front());
+        shard.queue.pop_front();
+        return request;
+    }
+
+    // Steal from the back of the most loaded victim, same NUMA node first
+    std::unique_ptr<Request> steal(size_t thief) {
+        for (bool same_node : {true, false}) {
+            size_t victim = thief;
+            size_t best = 0;
+            for (size_t v = 0; v < shards_.size(); v++) {
+                if (v == thief || (groups_[v].numa_node == groups_[thief].numa_node) != same_node) continue;
+                std::lock_guard<std::mutex> lock(shards_[v].mutex);
+                if (shards_[v].queue.size() > best) {
+                    best = shards_[v].queue.size();
+                    victim = v;
+                }
+            }
+            if (victim == thief) continue;
+            std::lock_guard<std::mutex> lock(shards_[victim].mutex);
+            if (shards_[victim].queue.empty()) continue;
+            auto request = std::move(shards_[victim].queue.back());
+            shards_[victim].queue.pop_back();
+            return request;
+        }
+        return nullptr;
+    }
+
+    void workerLoop(size_t i, Ort::Env& env, const std::string& model_path) {
+        const CoreGroup& group = groups_[i];
+        pinCurrentThread(group.cpus);   // before any allocation, so first touch lands on the local node
+
+        std::unique_ptr<Ort::Session> session;
+        std::string input_name, output_name;
+        try {
+            Ort::SessionOptions session_options;
+            session_options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+            session_options.SetIntraOpNumThreads(static_cast<int>(group.cpus.size()));
+            if (group.cpus.size() > 1) {
+                session_options.AddConfigEntry("session.intra_op_thread_affinities", affinityString(group.cpus).c_str());
+            }
+            session = std::make_unique<Ort::Session>(env, model_path.c_str(), session_options);
+            Ort::AllocatorWithDefaultOptions allocator;
+            input_name = session->GetInputNameAllocated(0, allocator).get();
+            output_name = session->GetOutputNameAllocated(0, allocator).get();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!init_error_) init_error_ = std::current_exception();
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ready_count_++;
+        }
+        cv_.notify_all();
+        if (!session) return;
+
+        Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+        const std::vector<int64_t> input_shape = {1, 1, 28, 28};
+        std::vector<float> local_input(28 * 28);   // touched here, so it lives on this node
+        const char* input_names[] = {input_name.c_str()};
+        const char* output_names[] = {output_name.c_str()};
+
+        while (true) {
+            auto request = popLocal(i);
+            if (!request && work_stealing_) {
+                request = steal(i);
+                if (request) shards_[i].stolen++;
+            }
+            if (!request) {
+                std::unique_lock<std::mutex> lock(mutex_);
+                if (stop_ && pending_ == 0) return;
+                cv_.wait_for(lock, std::chrono::milliseconds(1));
+                continue;
+            }
+
+            std::copy(request->input.begin(), request->input.end(), local_input.begin());
+            Ort::Value input = Ort::Value::CreateTensor<float>(memory_info, local_input.data(), local_input.size(),
+                                                               input_shape.data(), input_shape.size());
+            auto outputs = session->Run(Ort::RunOptions{nullptr}, input_names, &input, 1, output_names, 1);
+            const float* logits = outputs[0].GetTensorData<float>();
+            const int digit = static_cast<int>(std::max_element(logits, logits + 10) - logits);
+
+            shards_[i].executed++;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                pending_--;
+            }
+            request->promise.set_value({digit, static_cast<int>(i),
+                                        std::chrono::duration<double, std::milli>(Clock::now() - request->enqueued).count()});
+        }
+    }
+
+    void shutdown() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        for (auto& t : workers_) {
+            if (t.joinable()) t.join();
+        }
+    }
+
+    std::vector<CoreGroup> groups_;
+    bool work_stealing_;
+    std::vector<Shard> shards_;
+    std::vector<std::thread> workers_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    size_t ready_count_ = 0;
+    size_t pending_ = 0;
+    bool stop_ = false;
+    std::exception_ptr init_error_;
+};
+
+double percentile(std::vector<double> v, double q) {
+    if (v.empty()) return 0.0;
+    std::sort(v.begin(), v.end());
+    return v[std::min(v.size() - 1, static_cast<size_t>(q * (v.size() - 1) + 0.5))];
+}
+
+// ---------------- Main ----------------
+int main(int argc, char** argv) {
+    try {
+        std::cout << "--- NUMA / Core-Group Sharding with Work Stealing Demo ---" << std::endl;
+
+        int simulate = 0, requests = 5000;
+        std::string model_path = "/assets/models/mnist.onnx";
+        for (int i = 1; i < argc; i++) {
+            if (std::strcmp(argv[i], "--groups") == 0 && i + 1 < argc) simulate = std::max(1, std::atoi(argv[++i]));
+            else if (std::isdigit(static_cast<unsigned char>(argv[i][0]))) requests = std::max(1, std::atoi(argv[i]));
+            else model_path = argv[i];
+        }
+
+        const auto groups = detectCoreGroups(simulate);
+        std::cout << "Core groups:" << std::endl;
+        for (const auto& g : groups) {
+            std::cout << "  group " << g.id << " node " << g.numa_node << " cpus [";
+            for (size_t i = 0; i < g.cpus.size(); i++) std::cout << (i ? "," : "") << g.cpus[i];
+            std::cout << "] affinities \"" << affinityString(g.cpus) << "\"" << std::endl;
+        }
+
+        Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "NumaShardingDemo");
+        std::vector<float> digit_image(28 * 28, 0.0f);
+        for (int y = 6; y < 22; y++) digit_image[y * 28 + 14] = 1.0f;   // a "1"
+
+        for (bool stealing : {false, true}) {
+            ShardedRuntime runtime(env, model_path, groups, stealing);
+
+            // Skewed load: 60% of requests are routed to shard 0 (e.g. a hot tenant), the rest round-robin
+            std::mt19937 rng(7);
+            std::vector<std::future<Response>> futures;
+            futures.reserve(requests);
+            auto t0 = Clock::now();
+            for (int r = 0; r < requests; r++) {
+                const size_t hint = (rng() % 100 < 60) ? 0 : static_cast<size_t>(r);
+                futures.push_back(runtime.submit(digit_image, hint));
+            }
+            std::vector<double> latencies;
+            for (auto& f : futures) latencies.push_back(f.get().latency_ms);
+            const double seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+
+            std::printf("\nwork stealing %-3s | %8.0f req/s | p50 %7.2f ms | p99 %7.2f ms\n", stealing ? "on" : "off",
+                        requests / seconds, percentile(latencies, 0.50), percentile(latencies, 0.99));
+            runtime.printStats();
+        }
+    }
+    catch (const Ort::Exception& e) {
+        std::cerr << "ONNX Runtime error: " << e.what() << std::endl;
+        return -1;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Standard exception: " << e.what() << std::endl;
+        return -1;
+    }
+
+    std::cout << "--- Demo Complete ---" << std::endl;
+    return 0;
+}
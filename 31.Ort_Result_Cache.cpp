@@ -0,0 +1,345 @@
+/*
+
+Why do we need a result cache?
+----------------------------------------------------
+08.Ort_Session_Run.cpp and 10.Ort_Detect_YOLOv10n.cpp run the full model for every request. Real traffic repeats itself: the same
+digit crops are resubmitted by retries and batch jobs, and a static camera sends near-identical frames (after JPEG decode and
+resize, many are byte-identical). A model is deterministic for a given input, so each repeat computes a result we already have.
+
+ResultCache sits in front of Session::Run:
+
+    key   = XXH64(input bytes, seed A) + XXH64(input bytes, seed B) + model id + shape
+    value = a copy of the output tensors, shared (std::shared_ptr) between all hits
+
+    - Hash: XXH64 runs at several GB/s, so hashing a 3 KB MNIST input costs well under a microsecond. xxHash3 would be
+      faster, but it needs the xxhash library and this repo has no third-party dependencies besides ORT and OpenCV.
+      Two seeds give a 128-bit key, so the chance of a false hit is negligible without storing a copy of the input.
+    - Model id: XXH64 of the model file. A new model version never sees the old model's results.
+    - Bounded memory: the byte budget is split across 16 shards. Each shard is an LRU list plus a hash map under its own
+      mutex, so concurrent callers rarely contend. An insert evicts least-recently-used entries until the shard fits in its
+      budget. Entry size = outputs + shapes + fixed overhead.
+    - Counters: hits, misses, evictions, bytes in use (atomics, readable at any time).
+    - Concurrent misses for the same key both run the model. The second insert just refreshes the entry.
+
+The benchmark replays a synthetic MNIST trace: 20000 requests over 1000 distinct inputs, with a Zipf(1.1) popularity
+distribution, so a few inputs are very hot and many are rare. It is replayed on 4 threads, without and with the cache, and the
+tool reports throughput, p50/p99 latency and the cache counters.
+
+Usage:
+    ./ort_result_cache [model.onnx] [cache budget KB] [requests]
+
+*/
+
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <algorithm>
+#include <stdexcept>
+#include <exception>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <onnxruntime_cxx_api.h>
+
+using Clock = std::chrono::steady_clock;
+
+// ---------------- XXH64 ----------------
+namespace xxh {
+constexpr uint64_t P1 = 11400714785074694791ULL, P2 = 14029467366897019727ULL, P3 = 1609587929392839161ULL,
+                   P4 = 9650029242287828579ULL, P5 = 2870177450012600261ULL;
+
+inline uint64_t rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+inline uint64_t read64(const uint8_t* p) { uint64_t v; std::memcpy(&v, p, 8); return v; }   // little-endian hosts
+inline uint32_t read32(const uint8_t* p) { uint32_t v; std::memcpy(&v, p, 4); return v; }
+inline uint64_t round(uint64_t acc, uint64_t input) { return rotl(acc + input * P2, 31) * P1; }
+inline uint64_t merge(uint64_t acc, uint64_t v) { return (acc ^ round(0, v)) * P1 + P4; }
+
+uint64_t hash64(const void* data, size_t len, uint64_t seed) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    const uint8_t* end = p + len;
+    uint64_t h;
+    if (len >= 32) {
+        uint64_t v1 = seed + P1 + P2, v2 = seed + P2, v3 = seed, v4 = seed - P1;
+        for (; p + 32 <= end; p += 32) {
+            v1 = round(v1, read64(p));
+            v2 = round(v2, read64(p + 8));
+            v3 = round(v3, read64(p + 16));
+            v4 = round(v4, read64(p + 24));
+        }
+        h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+        h = merge(merge(merge(merge(h, v1), v2), v3), v4);
+    } else {
+        h = seed + P5;
+    }
+    h += len;
+    for (; p + 8 <= end; p += 8) h = rotl(h ^ round(0, read64(p)), 27) * P1 + P4;
+    if (p + 4 <= end) {
+        h = rotl(h ^ (read32(p) * P1), 23) * P2 + P3;
+        p += 4;
+    }
+    for (; p < end; p++) h = rotl(h ^ (*p * P5), 11) * P1;
+    h ^= h >> 33; h *= P2;
+    h ^= h >> 29; h *= P3;
+    h ^= h >> 32;
+    return h;
+}
+}  // namespace xxh
+
+// ---------------- Cache ----------------
+struct CacheKey {
+    uint64_t a, b;
+    bool operator==(const CacheKey& o) const { return a == o.a && b == o.b; }
+};
+
+struct CacheKeyHash {
+    size_t operator()(const CacheKey& k) const { return static_cast<size_t>(k.a); }
+};
+
+struct CachedTensor {
+    std::vector<int64_t> shape;
+    std::vector<float> data;
+};
+using CachedResult = std::vector<CachedTensor>;
+
+struct CacheStats {
+    uint64_t hits, misses, evictions, bytes, entries;
+};
+
+class ResultCache {
+public:
+    static constexpr size_t kShards = 16;
+    static constexpr size_t kEntryOverhead = 128;   // list node + map node + control block, roughly
+
+    explicit ResultCache(size_t budget_bytes) : shard_budget_(std::max<size_t>(1, budget_bytes / kShards)) {}
+
+    static CacheKey makeKey(uint64_t model_id, const void* input, size_t bytes, const std::vector<int64_t>& shape) {
+        uint64_t shape_hash = xxh::hash64(shape.data(), shape.size() * sizeof(int64_t), model_id);
+        return {xxh::hash64(input, bytes, shape_hash), xxh::hash64(input, bytes, ~shape_hash)};
+    }
+
+    std::shared_ptr<const CachedResult> get(const CacheKey& key) {
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.map.find(key);
+        if (it == shard.map.end()) {
+            misses_++;
+            return nullptr;
+        }
+        shard.lru.splice(shard.lru.begin(), shard.lru, it->second);   // most recently used to the front
+        hits_++;
+        return it->second->value;
+    }
+
+    void put(const CacheKey& key, std::shared_ptr<const CachedResult> value) {
+        size_t size = kEntryOverhead;
+        for (const auto& t : *value) size += t.data.size() * sizeof(float) + t.shape.size() * sizeof(int64_t);
+        if (size > shard_budget_) return;   // never cache something larger than a whole shard
+
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.map.find(key);
+        if (it != shard.map.end()) {
+            shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+            return;
+        }
+        while (shard.bytes + size > shard_budget_ && !shard.lru.empty()) {
+            const Entry& victim = shard.lru.back();
+            shard.bytes -= victim.size;
+            bytes_ -= victim.size;
+            shard.map.erase(victim.key);
+            shard.lru.pop_back();
+            evictions_++;
+            entries_--;
+        }
+        shard.lru.push_front({key, std::move(value), size});
+        shard.map[key] = shard.lru.begin();
+        shard.bytes += size;
+        bytes_ += size;
+        entries_++;
+    }
+
+    CacheStats stats() const { return {hits_.load(), misses_.load(), evictions_.load(), bytes_.load(), entries_.load()}; }
+
+private:
+    struct Entry {
+        CacheKey key;
+        std::shared_ptr<const CachedResult> value;
+        size_t size;
+    };
+    struct Shard {
+        std::mutex mutex;
+        std::list<Entry> lru;
+        std::unordered_map<CacheKey, std::list<Entry>::iterator, CacheKeyHash> map;
+        size_t bytes = 0;
+    };
+
+    // The high bits pick the shard, the low bits index the shard's hash map
+    Shard& shardFor(const CacheKey& key) { return shards_[(key.a >> 60) % kShards]; }
+
+    const size_t shard_budget_;
+    Shard shards_[kShards];
+    std::atomic<uint64_t> hits_{0}, misses_{0}, evictions_{0}, bytes_{0}, entries_{0};
+};
+
+// Session::Run with an optional cache in front of it (single float input)
+class CachedSession {
+public:
+    CachedSession(Ort::Session& session, ResultCache* cache, uint64_t model_id)
+        : session_(session), cache_(cache), model_id_(model_id) {
+        Ort::AllocatorWithDefaultOptions allocator;
+        input_name_ = session.GetInputNameAllocated(0, allocator).get();
+        for (size_t i = 0; i < session.GetOutputCount(); i++) {
+            output_names_.emplace_back(session.GetOutputNameAllocated(i, allocator).get());
+        }
+        for (auto& name : output_names_) output_name_ptrs_.push_back(name.c_str());
+    }
+
+    std::shared_ptr<const CachedResult> run(const std::vector<float>& input, const std::vector<int64_t>& shape) {
+        CacheKey key{};
+        if (cache_) {
+            key = ResultCache::makeKey(model_id_, input.data(), input.size() * sizeof(float), shape);
+            if (auto hit = cache_->get(key)) return hit;
+        }
+
+        Ort::Value tensor = Ort::Value::CreateTensor<float>(memory_info_, const_cast<float*>(input.data()), input.size(),
+                                                            shape.data(), shape.size());
+        const char* input_names[] = {input_name_.c_str()};
+        auto outputs = session_.Run(Ort::RunOptions{nullptr}, input_names, &tensor, 1,
+                                    output_name_ptrs_.data(), output_name_ptrs_.size());
+
+        auto result = std::make_shared<CachedResult>();
+        for (auto& out : outputs) {
+            auto info = out.GetTensorTypeAndShapeInfo();
+            const float* data = out.GetTensorData<float>();
+            result->push_back({info.GetShape(), std::vector<float>(data, data + info.GetElementCount())});
+        }
+        if (cache_) cache_->put(key, result);
+        return result;
+    }
+
+private:
+    Ort::Session& session_;
+    ResultCache* cache_;
+    uint64_t model_id_;
+    std::string input_name_;
+    std::vector<std::string> output_names_;
+    std::vector<const char*> output_name_ptrs_;
+    Ort::MemoryInfo memory_info_ = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+};
+
+uint64_t modelId(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) throw std::runtime_error("cannot read model " + path);
+    std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    return xxh::hash64(bytes.data(), bytes.size(), 0);
+}
+
+double percentile(std::vector<double> v, double q) {
+    if (v.empty()) return 0.0;
+    std::sort(v.begin(), v.end());
+    return v[std::min(v.size() - 1, static_cast<size_t>(q * (v.size() - 1) + 0.5))];
+}
+
+// ---------------- Main ----------------
+int main(int argc, char** argv) {
+    try {
+        std::cout << "--- Content-Hash Result Cache Demo ---" << std::endl;
+
+        const std::string model_path = argc > 1 ? argv[1] : "/assets/models/mnist.onnx";
+        const size_t budget_kb = argc > 2 ? std::max(1, std::atoi(argv[2])) : 64;
+        const int num_requests = argc > 3 ? std::max(1, std::atoi(argv[3])) : 20000;
+        const int num_unique = 1000, num_threads = 4;
+        const std::vector<int64_t> shape = {1, 1, 28, 28};
+
+        Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "ResultCacheDemo");
+        Ort::SessionOptions session_options;
+        session_options.SetIntraOpNumThreads(1);
+        session_options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+        Ort::Session session(env, model_path.c_str(), session_options);
+        const uint64_t model_id = modelId(model_path);
+
+        // 1. Distinct inputs and a Zipf(1.1) trace over them
+        std::mt19937 rng(2024);
+        std::uniform_real_distribution<float> pixel(0.f, 1.f);
+        std::vector<std::vector<float>> inputs(num_unique, std::vector<float>(28 * 28));
+        for (auto& img : inputs) {
+            for (auto& v : img) v = pixel(rng);
+        }
+        std::vector<double> weights(num_unique);
+        for (int i = 0; i < num_unique; i++) weights[i] = 1.0 / std::pow(i + 1, 1.1);
+        std::discrete_distribution<int> zipf(weights.begin(), weights.end());
+        std::vector<int> trace(num_requests);
+        for (auto& t : trace) t = zipf(rng);
+
+        std::printf("Trace: %d requests, %d distinct inputs, Zipf(1.1) | cache budget %zu KB | %d threads\n",
+                    num_requests, num_unique, budget_kb, num_threads);
+        std::printf("\n%-8s | %9s | %8s | %8s | %8s | %9s | %6s | %s\n",
+                    "mode", "req/s", "p50 us", "p99 us", "hit rate", "evictions", "KB", "entries");
+
+        // 2. Replay the trace without and with the cache
+        for (bool use_cache : {false, true}) {
+            ResultCache cache(budget_kb * 1024);
+            std::vector<std::vector<double>> latencies(num_threads);
+            std::vector<std::exception_ptr> errors(num_threads);
+            std::atomic<size_t> next{0};
+
+            // An exception must not escape a std::thread (std::terminate): keep it and rethrow after the join
+            auto worker = [&](int id) {
+                try {
+                    CachedSession cached(session, use_cache ? &cache : nullptr, model_id);
+                    for (size_t r = next++; r < trace.size(); r = next++) {
+                        auto t0 = Clock::now();
+                        auto result = cached.run(inputs[trace[r]], shape);
+                        latencies[id].push_back(std::chrono::duration<double, std::micro>(Clock::now() - t0).count());
+                        if (result->empty()) throw std::runtime_error("model returned no outputs");
+                    }
+                } catch (...) {
+                    errors[id] = std::current_exception();
+                    next = trace.size();   // stop the other workers
+                }
+            };
+
+            auto t0 = Clock::now();
+            std::vector<std::thread> threads;
+            for (int t = 1; t < num_threads; t++) threads.emplace_back(worker, t);
+            worker(0);
+            for (auto& t : threads) t.join();
+            for (const auto& e : errors) {
+                if (e) std::rethrow_exception(e);
+            }
+            const double seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+
+            std::vector<double> all;
+            for (const auto& l : latencies) all.insert(all.end(), l.begin(), l.end());
+            const CacheStats s = cache.stats();
+            const double hit_rate = s.hits + s.misses ? 100.0 * s.hits / (s.hits + s.misses) : 0.0;
+            std::printf("%-8s | %9.0f | %8.1f | %8.1f | %7.1f%% | %9llu | %6.1f | %llu\n", use_cache ? "cache" : "no cache",
+                        num_requests / seconds, percentile(all, 0.50), percentile(all, 0.99), hit_rate,
+                        static_cast<unsigned long long>(s.evictions), s.bytes / 1024.0,
+                        static_cast<unsigned long long>(s.entries));
+        }
+    }
+    catch (const Ort::Exception& e) {
+        std::cerr << "ONNX Runtime error: " << e.what() << std::endl;
+        return -1;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Standard exception: " << e.what() << std::endl;
+        return -1;
+    }
+
+    std::cout << "--- Demo Complete ---" << std::endl;
+    return 0;
+}
@@ -0,0 +1,350 @@
+/*
+
+Why do we need memory telemetry?
+----------------------------------------------------
+01.Ort_MemoryInfo.cpp only prints static Ort::MemoryInfo fields (name, type, device id). 11.cuda_memory_info.cpp asks the CUDA
+driver for free/total memory, and that does not help on CPU-only hosts. Neither tells us how much memory a running session
+actually costs, so replica counts per host are guessed, and the first sign of a bad guess is the OOM killer.
+
+MemoryTelemetry measures at three levels:
+
+    - Session arena : allocator stats from the session's CPU arena (Ort::Allocator(session, info).GetStats(), ORT >= 1.23):
+                      InUse, MaxInUse (peak), TotalAllocated (reserved from the OS) and NumAllocs. With older headers
+                      (ORT_API_VERSION < 23) these columns show n/a, and the RSS-based numbers below are the only source.
+    - Per Run       : activation peak. Before the Run the process peak RSS (VmHWM) is reset through /proc/self/clear_refs.
+                      After the Run, VmHWM minus the RSS before it is the memory the Run touched. The arena's peak growth
+                      over the Run is also counted. Once the arena holds its working set, later Runs of the same shape
+                      reuse it and add nothing, so the recorded value is the maximum over all Runs.
+    - Process       : RSS and peak RSS from /proc/self/status, plus one row per device backend. CPU (/proc/meminfo) is the
+                      default. A CUDA backend (cudaMemGetInfo, as in 11.cuda_memory_info.cpp) is compiled in with
+                      -DTELEMETRY_CUDA. Other devices implement MemoryBackend and are added with addBackend().
+
+Budget enforcement: createSession() estimates what a new session will cost before it creates one. For the first session of a
+model the estimate is 2x the model file; after that it is the measured creation cost plus the worst activation peak of earlier
+sessions of the same model. If current RSS + estimate exceeds the budget, the session (replica) is refused with a reason, and
+nothing is allocated.
+
+The demo creates replicas of a model until the budget refuses one, runs each replica twice and prints the report.
+
+Usage:
+    ./ort_memory_telemetry [model.onnx] [budget MB] [max replicas]
+
+*/
+
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <mutex>
+#include <memory>
+#include <random>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <cstdio>
+#include <cstdlib>
+#include <onnxruntime_cxx_api.h>
+#ifdef TELEMETRY_CUDA
+#include <cuda_runtime.h>
+#endif
+
+// ---------------- Process memory ----------------
+struct ProcessMemory {
+    double rss_mb = 0.0;
+    double peak_mb = 0.0;   // VmHWM, since process start or the last resetPeakRss()
+};
+
+ProcessMemory processMemory() {
+    ProcessMemory mem;
+    std::ifstream status("/proc/self/status");
+    std::string key;
+    double kb = 0.0;
+    while (status >> key) {
+        if (key == "VmRSS:" && status >> kb) mem.rss_mb = kb / 1024.0;
+        else if (key == "VmHWM:" && status >> kb) mem.peak_mb = kb / 1024.0;
+    }
+    return mem;
+}
+
+// Writing 5 to clear_refs resets VmHWM to the current RSS (Linux >= 4.0)
+bool resetPeakRss() {
+    std::ofstream clear_refs("/proc/self/clear_refs");
+    return static_cast<bool>(clear_refs << "5");
+}
+
+// ---------------- Device backends ----------------
+struct DeviceMemory {
+    std::string device;
+    double used_mb = 0.0;
+    double total_mb = 0.0;
+};
+
+class MemoryBackend {
+public:
+    virtual ~MemoryBackend() = default;
+    virtual std::vector<DeviceMemory> query() = 0;
+};
+
+class CpuBackend : public MemoryBackend {
+public:
+    std::vector<DeviceMemory> query() override {
+        std::ifstream meminfo("/proc/meminfo");
+        std::string key;
+        double kb = 0.0, total = 0.0, available = 0.0;
+        while (meminfo >> key >> kb) {
+            if (key == "MemTotal:") total = kb / 1024.0;
+            else if (key == "MemAvailable:") available = kb / 1024.0;
+            meminfo.ignore(64, '\n');
+        }
+        return {{"cpu", total - available, total}};
+    }
+};
+
+#ifdef TELEMETRY_CUDA
+class CudaBackend : public MemoryBackend {
+public:
+    std::vector<DeviceMemory> query() override {
+        std::vector<DeviceMemory> devices;
+        int count = 0;
+        if (cudaGetDeviceCount(&count) != cudaSuccess) return devices;
+        for (int device = 0; device < count; device++) {
+            size_t free_bytes = 0, total_bytes = 0;
+            cudaSetDevice(device);
+            if (cudaMemGetInfo(&free_bytes, &total_bytes) != cudaSuccess) continue;
+            devices.push_back({"cuda:" + std::to_string(device), (total_bytes - free_bytes) / (1024.0 * 1024.0),
+                               total_bytes / (1024.0 * 1024.0)});
+        }
+        return devices;
+    }
+};
+#endif
+
+// ---------------- Session arena ----------------
+struct ArenaStats {
+    bool available = false;
+    double in_use_mb = 0.0;
+    double peak_mb = 0.0;
+    double reserved_mb = 0.0;
+    long long num_allocs = 0;
+};
+
+ArenaStats arenaStats(const Ort::Session& session) {
+    ArenaStats stats;
+#if ORT_API_VERSION >= 23
+    Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+    Ort::Allocator allocator(session, memory_info);
+    Ort::KeyValuePairs kvps = allocator.GetStats();
+    auto value = [&kvps](const char* key) {
+        const char* v = kvps.GetValue(key);
+        return v ? std::atoll(v) : 0LL;
+    };
+    stats.available = true;
+    stats.in_use_mb = value("InUse") / (1024.0 * 1024.0);
+    stats.peak_mb = value("MaxInUse") / (1024.0 * 1024.0);
+    stats.reserved_mb = value("TotalAllocated") / (1024.0 * 1024.0);
+    stats.num_allocs = value("NumAllocs");
+#else
+    (void)session;
+#endif
+    return stats;
+}
+
+// ---------------- Telemetry + budget ----------------
+class MemoryTelemetry {
+public:
+    // budget_mb <= 0: no limit
+    explicit MemoryTelemetry(double budget_mb) : budget_mb_(budget_mb) {
+        backends_.push_back(std::make_unique<CpuBackend>());
+    }
+
+    void addBackend(std::unique_ptr<MemoryBackend> backend) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        backends_.push_back(std::move(backend));
+    }
+
+    // Creates and tracks a session if the budget allows it, otherwise returns nullptr and sets `reason`
+    Ort::Session* createSession(const std::string& name, Ort::Env& env, const std::string& model_path,
+                                const Ort::SessionOptions& options, std::string* reason = nullptr) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const double estimate = estimateLocked(model_path);
+        const double rss_before = processMemory().rss_mb;
+        if (budget_mb_ > 0 && rss_before + estimate > budget_mb_) {
+            if (reason) {
+                std::ostringstream ss;
+                ss << "RSS " << static_cast<int>(rss_before) << " MB + estimated " << static_cast<int>(estimate)
+                   << " MB > budget " << static_cast<int>(budget_mb_) << " MB";
+                *reason = ss.str();
+            }
+            return nullptr;
+        }
+
+        auto session = std::make_unique<Ort::Session>(env, model_path.c_str(), options);
+        Tracked tracked;
+        tracked.name = name;
+        tracked.model_path = model_path;
+        tracked.create_mb = std::max(0.0, processMemory().rss_mb - rss_before);
+        tracked.session = std::move(session);
+        sessions_.push_back(std::move(tracked));
+        return sessions_.back().session.get();
+    }
+
+    // Runs `run` (one Session::Run on `session`) and records its activation peak
+    void profileRun(Ort::Session* session, const std::function<void()>& run) {
+        const ArenaStats arena_before = arenaStats(*session);
+        const bool hwm_reset = resetPeakRss();
+        const double rss_before = processMemory().rss_mb;
+
+        run();
+
+        const ArenaStats arena_after = arenaStats(*session);
+        double peak = hwm_reset ? std::max(0.0, processMemory().peak_mb - rss_before) : 0.0;
+        if (arena_after.available && arena_after.peak_mb > arena_before.peak_mb) {
+            peak = std::max(peak, arena_after.peak_mb - arena_before.in_use_mb);
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (Tracked* tracked = findLocked(session)) {
+            tracked->run_peak_mb = std::max(tracked->run_peak_mb, peak);
+            tracked->runs++;
+        }
+    }
+
+    void report(std::ostream& out) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        char line[256];
+        std::snprintf(line, sizeof(line), "%-10s | %9s | %8s | %10s | %9s | %12s | %9s | %4s\n", "session", "create MB",
+                      "arena MB", "arena peak", "reserved", "arena allocs", "run peak", "runs");
+        out << line;
+        for (const auto& t : sessions_) {
+            const ArenaStats arena = arenaStats(*t.session);
+            if (arena.available) {
+                std::snprintf(line, sizeof(line), "%-10s | %9.1f | %8.1f | %10.1f | %9.1f | %12lld | %9.1f | %4d\n",
+                              t.name.c_str(), t.create_mb, arena.in_use_mb, arena.peak_mb, arena.reserved_mb,
+                              arena.num_allocs, t.run_peak_mb, t.runs);
+            } else {
+                std::snprintf(line, sizeof(line), "%-10s | %9.1f | %8s | %10s | %9s | %12s | %9.1f | %4d\n",
+                              t.name.c_str(), t.create_mb, "n/a", "n/a", "n/a", "n/a", t.run_peak_mb, t.runs);
+            }
+            out << line;
+        }
+
+        const ProcessMemory mem = processMemory();
+        std::snprintf(line, sizeof(line), "\nprocess    | RSS %.1f MB | peak RSS %.1f MB | budget %s\n", mem.rss_mb,
+                      mem.peak_mb, budget_mb_ > 0 ? (std::to_string(static_cast<int>(budget_mb_)) + " MB").c_str() : "none");
+        out << line;
+        for (auto& backend : backends_) {
+            for (const auto& dev : backend->query()) {
+                std::snprintf(line, sizeof(line), "device     | %-7s | used %.0f / %.0f MB\n", dev.device.c_str(),
+                              dev.used_mb, dev.total_mb);
+                out << line;
+            }
+        }
+    }
+
+private:
+    struct Tracked {
+        std::string name, model_path;
+        std::unique_ptr<Ort::Session> session;
+        double create_mb = 0.0;
+        double run_peak_mb = 0.0;
+        int runs = 0;
+    };
+
+    Tracked* findLocked(const Ort::Session* session) {
+        for (auto& t : sessions_) {
+            if (t.session.get() == session) return &t;
+        }
+        return nullptr;
+    }
+
+    // Worst measured cost of an earlier session of the same model, else 2x the model file
+    double estimateLocked(const std::string& model_path) const {
+        double estimate = 0.0;
+        for (const auto& t : sessions_) {
+            if (t.model_path == model_path) estimate = std::max(estimate, t.create_mb + t.run_peak_mb);
+        }
+        if (estimate > 0.0) return estimate;
+        std::ifstream model(model_path, std::ios::binary | std::ios::ate);
+        return model ? 2.0 * static_cast<double>(model.tellg()) / (1024.0 * 1024.0) : 0.0;
+    }
+
+    const double budget_mb_;
+    std::mutex mutex_;
+    std::vector<Tracked> sessions_;
+    std::vector<std::unique_ptr<MemoryBackend>> backends_;
+};
+
+// ---------------- Main ----------------
+int main(int argc, char** argv) {
+    try {
+        std::cout << "--- Memory Telemetry Demo ---" << std::endl;
+
+        const std::string model_path = argc > 1 ? argv[1] : "/assets/models/yolov10n.onnx";
+        const double budget_mb = argc > 2 ? std::atof(argv[2]) : 256.0;
+        const int max_replicas = argc > 3 ? std::max(1, std::atoi(argv[3])) : 16;
+
+        Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "MemoryTelemetryDemo");
+        Ort::SessionOptions session_options;
+        session_options.SetIntraOpNumThreads(1);
+        session_options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+
+        MemoryTelemetry telemetry(budget_mb);
+#ifdef TELEMETRY_CUDA
+        telemetry.addBackend(std::make_unique<CudaBackend>());
+#endif
+        std::cout << "Model: " << model_path << " | budget: " << budget_mb << " MB | arena stats: "
+                  << (ORT_API_VERSION >= 23 ? "GetStats" : "n/a (ORT_API_VERSION < 23)") << std::endl;
+
+        Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<float> dist(0.f, 1.f);
+
+        // 1. Add replicas until the budget refuses one, running each twice
+        for (int r = 0; r < max_replicas; r++) {
+            std::string reason;
+            Ort::Session* session = telemetry.createSession("replica" + std::to_string(r), env, model_path,
+                                                            session_options, &reason);
+            if (!session) {
+                std::cout << "Replica " << r << " refused: " << reason << std::endl;
+                break;
+            }
+
+            Ort::AllocatorWithDefaultOptions allocator;
+            auto input_name = session->GetInputNameAllocated(0, allocator);
+            auto output_name = session->GetOutputNameAllocated(0, allocator);
+            const char* input_names[] = {input_name.get()};
+            const char* output_names[] = {output_name.get()};
+            std::vector<int64_t> shape = session->GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+            size_t count = 1;
+            for (auto& d : shape) {
+                if (d < 0) d = 1;
+                count *= static_cast<size_t>(d);
+            }
+            std::vector<float> data(count);
+            for (auto& v : data) v = dist(rng);
+            Ort::Value input = Ort::Value::CreateTensor<float>(memory_info, data.data(), data.size(), shape.data(), shape.size());
+
+            for (int i = 0; i < 2; i++) {
+                telemetry.profileRun(session, [&]() {
+                    session->Run(Ort::RunOptions{nullptr}, input_names, &input, 1, output_names, 1);
+                });
+            }
+        }
+
+        // 2. Report
+        std::cout << std::endl;
+        telemetry.report(std::cout);
+    }
+    catch (const Ort::Exception& e) {
+        std::cerr << "ONNX Runtime error: " << e.what() << std::endl;
+        return -1;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Standard exception: " << e.what() << std::endl;
+        return -1;
+    }
+
+    std::cout << "--- Demo Complete ---" << std::endl;
+    return 0;
+}
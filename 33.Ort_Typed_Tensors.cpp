@@ -0,0 +1,454 @@
+/*
+
+Why do we need typed tensors?
+----------------------------------------------------
+Every example so far hard-codes Ort::Value::CreateTensor<float> and GetTensorMutableData<float>. That works for fp32 models only.
+Many deployable models declare other input and output types:
+
+    - uint8 inputs  : models exported with preprocessing inside take raw image bytes (NHWC or NCHW uint8)
+    - float16       : fp16 exports halve the weights and input bandwidth
+    - int8          : some quantized exports take int8 (or uint8) activations directly. QDQ models
+                      (QuantizeLinear/DequantizeLinear) keep float at the boundary and are int8 inside.
+
+Forcing these through a float buffer means an extra conversion pass, and a type error in Run when the model does not take float.
+
+The typed layer reads every input and output from the session's TypeInfo:
+
+    TensorSpec          : name, ONNXTensorElementDataType, shape (dynamic dims resolved by the caller)
+    TypedTensor         : owns a byte buffer of exactly count x sizeof(element) and wraps it with the untyped
+                          CreateTensor(memory_info, void*, bytes, shape, rank, type). data<T>() checks T against the declared
+                          type (Ort::TypeToTensorType<T>) and throws on a mismatch.
+    fillImage()         : writes uint8 pixels straight into the tensor's own type (float x scale, Ort::Float16_t, uint8 as is,
+                          int8 as pixel - 128), NCHW or NHWC, with no intermediate float image.
+    TypedView           : reads any float/fp16/uint8/int8 output element as float on access, without copying the output.
+
+The benchmark runs fp32 and int8-quantized variants of MNIST and YOLOv10n through the same code. The int8 variants are not in
+/assets. Create them with onnxruntime.quantization (quantize_static for QDQ, or quantize_dynamic) and pass the paths on the
+command line. Missing variants are skipped.
+
+    - MNIST  : 200 digits rendered with cv::putText (random font scale and offset), so they have known labels.
+               It reports accuracy vs labels and top-1 agreement with fp32.
+    - YOLO   : car.png. fp32 detections (conf >= 0.25) are the reference. It reports recall of same-class matches at IoU >= 0.5
+               and the mean confidence difference.
+    - Both   : p50 latency over the evaluated inputs, after one warm-up Run.
+
+Usage:
+    ./ort_typed_tensors [mnist_int8.onnx] [yolov10n_int8.onnx]
+
+*/
+
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+#include <cstdio>
+#include <cmath>
+#include <onnxruntime_cxx_api.h>
+#include <opencv2/opencv.hpp>
+
+using Clock = std::chrono::steady_clock;
+
+// ---------------- Typed tensors ----------------
+struct TensorSpec {
+    std::string name;
+    ONNXTensorElementDataType type = ONNX_TENSOR_ELEMENT_DATA_TYPE_UNDEFINED;
+    std::vector<int64_t> shape;
+};
+
+const char* typeName(ONNXTensorElementDataType type) {
+    switch (type) {
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT: return "float32";
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16: return "float16";
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8: return "uint8";
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8: return "int8";
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32: return "int32";
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64: return "int64";
+        default: return "other";
+    }
+}
+
+size_t elementSize(ONNXTensorElementDataType type) {
+    switch (type) {
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT: return sizeof(float);
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16: return sizeof(Ort::Float16_t);
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8: return sizeof(uint8_t);
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8: return sizeof(int8_t);
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32: return sizeof(int32_t);
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64: return sizeof(int64_t);
+        default: throw std::runtime_error(std::string("unsupported tensor element type ") + typeName(type));
+    }
+}
+
+std::vector<TensorSpec> inputSpecs(const Ort::Session& session) {
+    std::vector<TensorSpec> specs;
+    Ort::AllocatorWithDefaultOptions allocator;
+    for (size_t i = 0; i < session.GetInputCount(); i++) {
+        Ort::TypeInfo type_info = session.GetInputTypeInfo(i);   // owns the shape info viewed below
+        auto info = type_info.GetTensorTypeAndShapeInfo();
+        specs.push_back({session.GetInputNameAllocated(i, allocator).get(), info.GetElementType(), info.GetShape()});
+    }
+    return specs;
+}
+
+std::vector<TensorSpec> outputSpecs(const Ort::Session& session) {
+    std::vector<TensorSpec> specs;
+    Ort::AllocatorWithDefaultOptions allocator;
+    for (size_t i = 0; i < session.GetOutputCount(); i++) {
+        Ort::TypeInfo type_info = session.GetOutputTypeInfo(i);   // owns the shape info viewed below
+        auto info = type_info.GetTensorTypeAndShapeInfo();
+        specs.push_back({session.GetOutputNameAllocated(i, allocator).get(), info.GetElementType(), info.GetShape()});
+    }
+    return specs;
+}
+
+class TypedTensor {
+public:
+    TypedTensor(ONNXTensorElementDataType type, std::vector<int64_t> shape) : type_(type), shape_(std::move(shape)) {
+        count_ = 1;
+        for (auto d : shape_) {
+            if (d < 0) throw std::runtime_error("TypedTensor needs a concrete shape");
+            count_ *= static_cast<size_t>(d);
+        }
+        buffer_.resize(count_ * elementSize(type_));
+        value_ = Ort::Value::CreateTensor(memory_info_, buffer_.data(), buffer_.size(), shape_.data(), shape_.size(), type_);
+    }
+
+    TypedTensor(const TypedTensor&) = delete;
+    TypedTensor& operator=(const TypedTensor&) = delete;
+
+    template <typename T>
+    T* data() {
+        if (Ort::TypeToTensorType<T>::type != type_) {
+            throw std::runtime_error(std::string("tensor holds ") + typeName(type_) + ", not " +
+                                     typeName(Ort::TypeToTensorType<T>::type));
+        }
+        return reinterpret_cast<T*>(buffer_.data());
+    }
+
+    ONNXTensorElementDataType type() const { return type_; }
+    const std::vector<int64_t>& shape() const { return shape_; }
+    size_t count() const { return count_; }
+    const Ort::Value& value() const { return value_; }
+
+private:
+    ONNXTensorElementDataType type_;
+    std::vector<int64_t> shape_;
+    size_t count_ = 0;
+    std::vector<uint8_t> buffer_;
+    Ort::MemoryInfo memory_info_ = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+    Ort::Value value_{nullptr};
+};
+
+template <typename T> T fromPixel(uint8_t v, float scale);
+template <> float fromPixel<float>(uint8_t v, float scale) { return v * scale; }
+template <> Ort::Float16_t fromPixel<Ort::Float16_t>(uint8_t v, float scale) { return Ort::Float16_t(v * scale); }
+template <> uint8_t fromPixel<uint8_t>(uint8_t v, float) { return v; }
+template <> int8_t fromPixel<int8_t>(uint8_t v, float) { return static_cast<int8_t>(static_cast<int>(v) - 128); }
+
+template <typename T>
+void fillImageAs(TypedTensor& tensor, const cv::Mat& image, float scale) {
+    // [N, C, H, W] when dim 1 matches the channel count, otherwise [N, H, W, C]
+    const auto& shape = tensor.shape();
+    const int channels = image.channels();
+    const bool nchw = shape.size() == 4 && shape[1] == channels;
+    const int h = image.rows, w = image.cols;
+    T* dst = tensor.data<T>();
+    for (int y = 0; y < h; y++) {
+        const uint8_t* row = image.ptr<uint8_t>(y);
+        for (int x = 0; x < w; x++) {
+            for (int c = 0; c < channels; c++) {
+                const size_t idx = nchw ? (static_cast<size_t>(c) * h + y) * w + x : (static_cast<size_t>(y) * w + x) * channels + c;
+                dst[idx] = fromPixel<T>(row[x * channels + c], scale);
+            }
+        }
+    }
+}
+
+// `image` is 8-bit and already sized to the tensor's H x W. `scale` applies to float and float16 only.
+void fillImage(TypedTensor& tensor, const cv::Mat& image, float scale) {
+    if (tensor.count() != image.total() * image.channels()) throw std::runtime_error("image does not match tensor shape");
+    switch (tensor.type()) {
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT: fillImageAs<float>(tensor, image, scale); break;
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16: fillImageAs<Ort::Float16_t>(tensor, image, scale); break;
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8: fillImageAs<uint8_t>(tensor, image, scale); break;
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8: fillImageAs<int8_t>(tensor, image, scale); break;
+        default: throw std::runtime_error(std::string("cannot fill an image into ") + typeName(tensor.type()));
+    }
+}
+
+// Read-only float view over an output of any supported element type
+class TypedView {
+public:
+    explicit TypedView(const Ort::Value& value) {
+        auto info = value.GetTensorTypeAndShapeInfo();
+        type_ = info.GetElementType();
+        shape_ = info.GetShape();
+        count_ = info.GetElementCount();
+        data_ = value.GetTensorRawData();
+        elementSize(type_);   // throws for unsupported types
+    }
+
+    float operator[](size_t i) const {
+        switch (type_) {
+            case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT: return static_cast<const float*>(data_)[i];
+            case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16: return static_cast<const Ort::Float16_t*>(data_)[i].ToFloat();
+            case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8: return static_cast<const uint8_t*>(data_)[i];
+            case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8: return static_cast<const int8_t*>(data_)[i];
+            case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32: return static_cast<float>(static_cast<const int32_t*>(data_)[i]);
+            case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64: return static_cast<float>(static_cast<const int64_t*>(data_)[i]);
+            default: return 0.f;
+        }
+    }
+
+    size_t size() const { return count_; }
+    const std::vector<int64_t>& shape() const { return shape_; }
+    ONNXTensorElementDataType type() const { return type_; }
+
+private:
+    ONNXTensorElementDataType type_ = ONNX_TENSOR_ELEMENT_DATA_TYPE_UNDEFINED;
+    std::vector<int64_t> shape_;
+    size_t count_ = 0;
+    const void* data_ = nullptr;
+};
+
+// ---------------- Typed model ----------------
+// Single image input; dynamic dims default to 1 (batch) or `default_size` (spatial)
+class TypedModel {
+public:
+    TypedModel(Ort::Env& env, const std::string& path, int default_size) {
+        Ort::SessionOptions session_options;
+        session_options.SetIntraOpNumThreads(1);
+        session_options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+        session_ = std::make_unique<Ort::Session>(env, path.c_str(), session_options);
+        inputs_ = inputSpecs(*session_);
+        outputs_ = outputSpecs(*session_);
+
+        std::vector<int64_t> shape = inputs_[0].shape;
+        for (size_t d = 0; d < shape.size(); d++) {
+            if (shape[d] < 0) shape[d] = d == 0 ? 1 : default_size;
+        }
+        input_ = std::make_unique<TypedTensor>(inputs_[0].type, shape);
+        for (const auto& out : outputs_) output_names_.push_back(out.name.c_str());
+    }
+
+    // Input H x W, from the [N,C,H,W] or [N,H,W,C] layout
+    cv::Size inputSize() const {
+        const auto& s = input_->shape();
+        const bool nchw = s[1] <= 4;
+        return nchw ? cv::Size(static_cast<int>(s[3]), static_cast<int>(s[2])) : cv::Size(static_cast<int>(s[2]), static_cast<int>(s[1]));
+    }
+
+    std::vector<Ort::Value> run(const cv::Mat& image, float scale) {
+        fillImage(*input_, image, scale);
+        const char* input_names[] = {inputs_[0].name.c_str()};
+        return session_->Run(Ort::RunOptions{nullptr}, input_names, &input_->value(), 1, output_names_.data(), output_names_.size());
+    }
+
+    void describe(const std::string& label) const {
+        auto print = [](const char* dir, const TensorSpec& spec) {
+            std::cout << "    " << dir << " " << spec.name << " : " << typeName(spec.type) << " [";
+            for (size_t i = 0; i < spec.shape.size(); i++) std::cout << spec.shape[i] << (i + 1 < spec.shape.size() ? "," : "");
+            std::cout << "]" << std::endl;
+        };
+        std::cout << label << std::endl;
+        for (const auto& spec : inputs_) print("in ", spec);
+        for (const auto& spec : outputs_) print("out", spec);
+    }
+
+private:
+    std::unique_ptr<Ort::Session> session_;
+    std::vector<TensorSpec> inputs_, outputs_;
+    std::vector<const char*> output_names_;
+    std::unique_ptr<TypedTensor> input_;
+};
+
+// ---------------- Evaluation ----------------
+struct Detection {
+    cv::Rect2f box;
+    float conf;
+    int class_id;
+};
+
+double percentile(std::vector<double> v, double q) {
+    if (v.empty()) return 0.0;
+    std::sort(v.begin(), v.end());
+    return v[std::min(v.size() - 1, static_cast<size_t>(q * (v.size() - 1) + 0.5))];
+}
+
+float iou(const cv::Rect2f& a, const cv::Rect2f& b) {
+    const float x1 = std::max(a.x, b.x), y1 = std::max(a.y, b.y);
+    const float x2 = std::min(a.x + a.width, b.x + b.width), y2 = std::min(a.y + a.height, b.y + b.height);
+    const float inter = std::max(0.f, x2 - x1) * std::max(0.f, y2 - y1);
+    const float uni = a.width * a.height + b.width * b.height - inter;
+    return uni > 0.f ? inter / uni : 0.f;
+}
+
+// 28x28 white-on-black digits with known labels
+std::vector<std::pair<cv::Mat, int>> renderDigits(int count) {
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<double> scale(0.7, 1.0);
+    std::uniform_int_distribution<int> shift(-2, 2);
+    std::vector<std::pair<cv::Mat, int>> digits;
+    for (int i = 0; i < count; i++) {
+        cv::Mat img = cv::Mat::zeros(28, 28, CV_8UC1);
+        const int label = i % 10;
+        cv::putText(img, std::to_string(label), cv::Point(7 + shift(rng), 21 + shift(rng)), cv::FONT_HERSHEY_SIMPLEX,
+                    scale(rng), cv::Scalar(255), 2);
+        digits.emplace_back(img, label);
+    }
+    return digits;
+}
+
+struct MnistResult {
+    double accuracy = 0.0, p50_ms = 0.0;
+    std::vector<int> predictions;
+};
+
+MnistResult evalMnist(TypedModel& model, const std::vector<std::pair<cv::Mat, int>>& digits) {
+    MnistResult result;
+    std::vector<double> latencies;
+    int correct = 0;
+    model.run(digits[0].first, 1.0f);   // warm-up
+    for (const auto& [img, label] : digits) {
+        auto t0 = Clock::now();
+        auto outputs = model.run(img, 1.0f);   // this MNIST model takes raw 0..255 pixels
+        latencies.push_back(std::chrono::duration<double, std::milli>(Clock::now() - t0).count());
+
+        TypedView scores(outputs[0]);
+        int best = 0;
+        for (size_t c = 1; c < scores.size(); c++) {
+            if (scores[c] > scores[best]) best = static_cast<int>(c);
+        }
+        result.predictions.push_back(best);
+        correct += best == label;
+    }
+    result.accuracy = 100.0 * correct / digits.size();
+    result.p50_ms = percentile(latencies, 0.50);
+    return result;
+}
+
+struct YoloResult {
+    double p50_ms = 0.0;
+    std::vector<Detection> detections;
+};
+
+YoloResult evalYolo(TypedModel& model, const cv::Mat& image, int runs) {
+    YoloResult result;
+    cv::Mat resized;
+    cv::resize(image, resized, model.inputSize());
+    std::vector<double> latencies;
+    model.run(resized, 1.0f / 255.0f);   // warm-up
+    for (int r = 0; r < runs; r++) {
+        auto t0 = Clock::now();
+        auto outputs = model.run(resized, 1.0f / 255.0f);
+        latencies.push_back(std::chrono::duration<double, std::milli>(Clock::now() - t0).count());
+
+        if (r + 1 < runs) continue;
+        // [1, N, 6]: x1, y1, x2, y2, conf, class_id
+        TypedView out(outputs[0]);
+        const size_t rows = out.size() / 6;
+        for (size_t i = 0; i < rows; i++) {
+            const float conf = out[i * 6 + 4];
+            if (conf < 0.25f) continue;
+            const float x1 = out[i * 6], y1 = out[i * 6 + 1], x2 = out[i * 6 + 2], y2 = out[i * 6 + 3];
+            result.detections.push_back({cv::Rect2f(x1, y1, x2 - x1, y2 - y1), conf, static_cast<int>(out[i * 6 + 5])});
+        }
+    }
+    result.p50_ms = percentile(latencies, 0.50);
+    return result;
+}
+
+bool exists(const std::string& path) { return std::ifstream(path).good(); }
+
+// ---------------- Main ----------------
+int main(int argc, char** argv) {
+    try {
+        std::cout << "--- Typed Tensors: fp32 vs int8 Demo ---" << std::endl;
+
+        const std::string mnist_fp32 = "/assets/models/mnist.onnx";
+        const std::string yolo_fp32 = "/assets/models/yolov10n.onnx";
+        const std::string mnist_int8 = argc > 1 ? argv[1] : "/assets/models/mnist_int8.onnx";
+        const std::string yolo_int8 = argc > 2 ? argv[2] : "/assets/models/yolov10n_int8.onnx";
+        const std::string image_path = "/assets/images/car.png";
+
+        Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "TypedTensorsDemo");
+
+        // 1. MNIST
+        const auto digits = renderDigits(200);
+        TypedModel mnist(env, mnist_fp32, 28);
+        mnist.describe("MNIST fp32 (" + mnist_fp32 + ")");
+        const MnistResult m32 = evalMnist(mnist, digits);
+
+        std::printf("\n%-12s | %8s | %9s | %s\n", "MNIST", "p50 ms", "accuracy", "agreement with fp32");
+        std::printf("%-12s | %8.3f | %8.1f%% | %s\n", "fp32", m32.p50_ms, m32.accuracy, "-");
+        if (exists(mnist_int8)) {
+            TypedModel mnist_q(env, mnist_int8, 28);
+            const MnistResult m8 = evalMnist(mnist_q, digits);
+            int agree = 0;
+            for (size_t i = 0; i < digits.size(); i++) agree += m8.predictions[i] == m32.predictions[i];
+            std::printf("%-12s | %8.3f | %8.1f%% | %.1f%%\n", "int8", m8.p50_ms, m8.accuracy, 100.0 * agree / digits.size());
+            mnist_q.describe("MNIST int8 (" + mnist_int8 + ")");
+        } else {
+            std::cout << "int8 variant not found (" << mnist_int8 << "), skipped." << std::endl;
+        }
+
+        // 2. YOLOv10n
+        cv::Mat image = cv::imread(image_path);
+        if (image.empty()) {
+            std::cerr << "Error: could not load image at " << image_path << std::endl;
+            return -1;
+        }
+        TypedModel yolo(env, yolo_fp32, 640);
+        std::cout << std::endl;
+        yolo.describe("YOLOv10n fp32 (" + yolo_fp32 + ")");
+        const YoloResult y32 = evalYolo(yolo, image, 10);
+
+        std::printf("\n%-12s | %8s | %10s | %12s | %s\n", "YOLOv10n", "p50 ms", "detections", "recall@0.5", "mean |dconf|");
+        std::printf("%-12s | %8.2f | %10zu | %12s | %s\n", "fp32", y32.p50_ms, y32.detections.size(), "-", "-");
+        if (exists(yolo_int8)) {
+            TypedModel yolo_q(env, yolo_int8, 640);
+            const YoloResult y8 = evalYolo(yolo_q, image, 10);
+            int matched = 0;
+            double dconf = 0.0;
+            for (const auto& ref : y32.detections) {
+                const Detection* best = nullptr;
+                float best_iou = 0.5f;
+                for (const auto& d : y8.detections) {
+                    const float o = iou(ref.box, d.box);
+                    if (d.class_id == ref.class_id && o >= best_iou) {
+                        best_iou = o;
+                        best = &d;
+                    }
+                }
+                if (best) {
+                    matched++;
+                    dconf += std::fabs(best->conf - ref.conf);
+                }
+            }
+            const double recall = y32.detections.empty() ? 100.0 : 100.0 * matched / y32.detections.size();
+            std::printf("%-12s | %8.2f | %10zu | %11.1f%% | %.3f\n", "int8", y8.p50_ms, y8.detections.size(), recall,
+                        matched ? dconf / matched : 0.0);
+            yolo_q.describe("YOLOv10n int8 (" + yolo_int8 + ")");
+        } else {
+            std::cout << "int8 variant not found (" << yolo_int8 << "), skipped." << std::endl;
+        }
+    }
+    catch (const Ort::Exception& e) {
+        std::cerr << "ONNX Runtime error: " << e.what() << std::endl;
+        return -1;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Standard exception: " << e.what() << std::endl;
+        return -1;
+    }
+
+    std::cout << "--- Demo Complete ---" << std::endl;
+    return 0;
+}
@@ -0,0 +1,443 @@
+/*
+
+Why do we need in-graph preprocessing?
+----------------------------------------------------
+10.Ort_Detect_YOLOv10n.cpp prepares every frame in application code before session.Run:
+
+    cv::resize -> convertTo(CV_32F, 1/255) -> cv::split into a CHW float buffer -> CreateTensor<float>
+
+These are three full passes over the image on the calling thread, plus a 4.9 MB float buffer per frame. ORT never sees these
+steps, so it cannot thread them with its intra-op pool or fuse them with the first convolution.
+
+This tool rewrites a model so that the graph does the preprocessing itself. The new graph input is the decoded cv::Mat buffer as
+it is, uint8 NHWC (BGR order, as in 10.Ort_Detect_YOLOv10n.cpp):
+
+    frame_u8 [1, frame_h, frame_w, C] uint8
+        -> Resize (sizes = [1, H, W, C], linear, half_pixel like cv::INTER_LINEAR)   only with resize enabled
+        -> Cast (float)
+        -> Div (255)
+        -> Transpose (perm 0,3,1,2)
+        -> original input [1, C, H, W] float -> rest of the model, unchanged
+
+Resize runs first, on uint8 NHWC (ORT has a dedicated kernel for it). Cast/Div/Transpose then touch only H x W x C elements, not
+the full camera frame. Without resize the input is [1, H, W, C], and the caller resizes.
+
+ORT 1.22 added a model editor API for this kind of graph surgery. This repo builds against ORT 1.18, and ONNX files are plain
+protobuf, so the tool edits the ModelProto directly with a small wire-format writer:
+
+    - The original float input is removed from graph.input. The new uint8 input, the nodes and their constant initializers
+      (255, Resize roi/scales/sizes) are written in front of the original graph fields, so the nodes stay topologically sorted.
+      For IR version < 4 the constants are also listed in graph.input, as those versions require.
+    - Everything else (nodes, initializers, outputs, opsets, metadata) is copied byte for byte.
+    - Resize needs default-domain opset >= 11; older models can only be wrapped with resize disabled.
+
+The result is written to disk and loaded straight from memory (Ort::Session from a byte buffer).
+
+The benchmark runs YOLOv10n on car.png scaled to 640x640, 1280x720 and 1920x1080 frames. Host preprocessing (as in
+10.Ort_Detect_YOLOv10n.cpp) + Run is compared against binding the cv::Mat bytes to the wrapped model. It reports p50 end-to-end
+latency and the detection count from both paths.
+
+Usage:
+    ./ort_ingraph_preprocess [model.onnx] [wrapped.onnx] [runs] [--no-resize]
+
+*/
+
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <onnxruntime_cxx_api.h>
+#include <opencv2/opencv.hpp>
+
+using Clock = std::chrono::steady_clock;
+
+// ---------------- Protobuf wire format ----------------
+namespace pb {
+enum Wire { VARINT = 0, FIXED64 = 1, BYTES = 2, FIXED32 = 5 };
+
+struct Field {
+    uint32_t number;
+    uint32_t wire;
+    uint64_t varint;         // VARINT value
+    std::string_view bytes;  // BYTES payload
+    std::string_view raw;    // the whole field, tag included
+};
+
+void putVarint(std::string& out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<char>((v & 0x7f) | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<char>(v));
+}
+
+void putTag(std::string& out, uint32_t field, Wire wire) { putVarint(out, (static_cast<uint64_t>(field) << 3) | wire); }
+
+void putInt(std::string& out, uint32_t field, int64_t v) {
+    putTag(out, field, VARINT);
+    putVarint(out, static_cast<uint64_t>(v));
+}
+
+void putBytes(std::string& out, uint32_t field, std::string_view bytes) {
+    putTag(out, field, BYTES);
+    putVarint(out, bytes.size());
+    out.append(bytes.data(), bytes.size());
+}
+
+uint64_t getVarint(std::string_view in, size_t& pos) {
+    uint64_t v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (pos >= in.size()) throw std::runtime_error("truncated protobuf varint");
+        const uint8_t b = static_cast<uint8_t>(in[pos++]);
+        v |= static_cast<uint64_t>(b & 0x7f) << shift;
+        if (!(b & 0x80)) return v;
+    }
+    throw std::runtime_error("malformed protobuf varint");
+}
+
+// Top-level fields of one message, in file order
+std::vector<Field> parse(std::string_view msg) {
+    std::vector<Field> fields;
+    size_t pos = 0;
+    while (pos < msg.size()) {
+        const size_t begin = pos;
+        const uint64_t tag = getVarint(msg, pos);
+        Field f{static_cast<uint32_t>(tag >> 3), static_cast<uint32_t>(tag & 7), 0, {}, {}};
+        switch (f.wire) {
+            case VARINT: f.varint = getVarint(msg, pos); break;
+            case FIXED64: pos += 8; break;
+            case FIXED32: pos += 4; break;
+            case BYTES: {
+                const uint64_t len = getVarint(msg, pos);
+                if (len > msg.size() - pos) throw std::runtime_error("truncated protobuf field");
+                f.bytes = msg.substr(pos, len);
+                pos += len;
+                break;
+            }
+            default: throw std::runtime_error("unsupported protobuf wire type");
+        }
+        if (pos > msg.size()) throw std::runtime_error("truncated protobuf field");
+        f.raw = msg.substr(begin, pos - begin);
+        fields.push_back(f);
+    }
+    return fields;
+}
+}  // namespace pb
+
+// ---------------- ONNX messages ----------------
+// Field numbers and enums from onnx.proto
+namespace onnx {
+enum DataType { FLOAT = 1, UINT8 = 2, INT64 = 7 };
+enum AttrType { ATTR_INT = 2, ATTR_STRING = 3, ATTR_INTS = 7 };
+
+struct Dim {
+    int64_t value = -1;
+    std::string param;   // used when value < 0
+};
+
+std::string valueInfo(const std::string& name, DataType type, const std::vector<Dim>& dims) {
+    std::string shape;
+    for (const auto& d : dims) {
+        std::string dim;
+        if (d.value >= 0) pb::putInt(dim, 1, d.value);   // dim_value
+        else pb::putBytes(dim, 2, d.param);              // dim_param
+        pb::putBytes(shape, 1, dim);
+    }
+    std::string tensor_type;
+    pb::putInt(tensor_type, 1, type);      // elem_type
+    pb::putBytes(tensor_type, 2, shape);   // shape
+    std::string type_proto;
+    pb::putBytes(type_proto, 1, tensor_type);
+    std::string info;
+    pb::putBytes(info, 1, name);
+    pb::putBytes(info, 2, type_proto);
+    return info;
+}
+
+std::string attrInt(const std::string& name, int64_t v) {
+    std::string a;
+    pb::putBytes(a, 1, name);
+    pb::putInt(a, 3, v);
+    pb::putInt(a, 20, ATTR_INT);
+    return a;
+}
+
+std::string attrInts(const std::string& name, const std::vector<int64_t>& values) {
+    std::string a;
+    pb::putBytes(a, 1, name);
+    for (auto v : values) pb::putInt(a, 8, v);
+    pb::putInt(a, 20, ATTR_INTS);
+    return a;
+}
+
+std::string attrString(const std::string& name, const std::string& s) {
+    std::string a;
+    pb::putBytes(a, 1, name);
+    pb::putBytes(a, 4, s);
+    pb::putInt(a, 20, ATTR_STRING);
+    return a;
+}
+
+std::string node(const std::string& op, const std::vector<std::string>& inputs, const std::string& output,
+                 const std::vector<std::string>& attrs = {}) {
+    std::string n;
+    for (const auto& in : inputs) pb::putBytes(n, 1, in);
+    pb::putBytes(n, 2, output);
+    pb::putBytes(n, 3, "preprocess_" + op);
+    pb::putBytes(n, 4, op);
+    for (const auto& a : attrs) pb::putBytes(n, 5, a);
+    return n;
+}
+
+template <typename T>
+std::string tensor(const std::string& name, DataType type, const std::vector<T>& values, bool as_vector = true) {
+    std::string t;
+    if (as_vector) pb::putInt(t, 1, static_cast<int64_t>(values.size()));   // dims; scalars have none
+    pb::putInt(t, 2, type);
+    pb::putBytes(t, 8, name);
+    pb::putBytes(t, 9, std::string_view(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T)));   // raw_data, little-endian
+    return t;
+}
+}  // namespace onnx
+
+// ---------------- Model rewrite ----------------
+struct PreprocessSpec {
+    std::string input_name;            // the model's float NCHW input
+    int64_t channels = 3, height = 640, width = 640;
+    bool resize = true;
+    std::string frame_name = "frame_u8";
+};
+
+int64_t irVersion(std::string_view model) {
+    for (const auto& f : pb::parse(model)) {
+        if (f.number == 1 && f.wire == pb::VARINT) return static_cast<int64_t>(f.varint);
+    }
+    return 0;
+}
+
+int64_t defaultOpset(std::string_view model) {
+    for (const auto& f : pb::parse(model)) {
+        if (f.number != 8 || f.wire != pb::BYTES) continue;   // opset_import
+        std::string_view domain;
+        int64_t version = 0;
+        for (const auto& g : pb::parse(f.bytes)) {
+            if (g.number == 1) domain = g.bytes;
+            else if (g.number == 2) version = static_cast<int64_t>(g.varint);
+        }
+        if (domain.empty() || domain == "ai.onnx") return version;
+    }
+    return 0;
+}
+
+std::string wrapModel(const std::string& model, const PreprocessSpec& spec) {
+    const int64_t opset = defaultOpset(model);
+    if (spec.resize && opset < 11) {
+        throw std::runtime_error("Resize needs opset >= 11, model has opset " + std::to_string(opset) + " (use --no-resize)");
+    }
+
+    // New input, constants and nodes, written before the original graph fields
+    std::string graph;
+    std::vector<onnx::Dim> frame_dims = {{1, ""}, {spec.height, ""}, {spec.width, ""}, {spec.channels, ""}};
+    if (spec.resize) frame_dims = {{1, ""}, {-1, "frame_h"}, {-1, "frame_w"}, {spec.channels, ""}};
+    pb::putBytes(graph, 11, onnx::valueInfo(spec.frame_name, onnx::UINT8, frame_dims));
+
+    // IR < 4 requires every initializer to be listed in graph.input as well
+    const bool list_constants = irVersion(model) < 4;
+    auto constant = [&](const std::string& tensor, const std::string& name, onnx::DataType type, std::vector<onnx::Dim> dims) {
+        pb::putBytes(graph, 5, tensor);
+        if (list_constants) pb::putBytes(graph, 11, onnx::valueInfo(name, type, dims));
+    };
+
+    constant(onnx::tensor<float>("preprocess_255", onnx::FLOAT, {255.f}, false), "preprocess_255", onnx::FLOAT, {});
+    std::string current = spec.frame_name;
+    if (spec.resize) {
+        constant(onnx::tensor<float>("preprocess_roi", onnx::FLOAT, {}), "preprocess_roi", onnx::FLOAT, {{0, ""}});
+        constant(onnx::tensor<float>("preprocess_scales", onnx::FLOAT, {}), "preprocess_scales", onnx::FLOAT, {{0, ""}});
+        constant(onnx::tensor<int64_t>("preprocess_sizes", onnx::INT64, {1, spec.height, spec.width, spec.channels}),
+                 "preprocess_sizes", onnx::INT64, {{4, ""}});
+        pb::putBytes(graph, 1, onnx::node("Resize", {current, "preprocess_roi", "preprocess_scales", "preprocess_sizes"},
+                                          "preprocess_resized",
+                                          {onnx::attrString("mode", "linear"),
+                                           onnx::attrString("coordinate_transformation_mode", "half_pixel")}));
+        current = "preprocess_resized";
+    }
+    pb::putBytes(graph, 1, onnx::node("Cast", {current}, "preprocess_float", {onnx::attrInt("to", onnx::FLOAT)}));
+    pb::putBytes(graph, 1, onnx::node("Div", {"preprocess_float", "preprocess_255"}, "preprocess_scaled"));
+    pb::putBytes(graph, 1, onnx::node("Transpose", {"preprocess_scaled"}, spec.input_name, {onnx::attrInts("perm", {0, 3, 1, 2})}));
+
+    std::string result;
+    bool found_graph = false, found_input = false;
+    for (const auto& f : pb::parse(model)) {
+        if (f.number != 7 || f.wire != pb::BYTES) {   // not ModelProto.graph: copy unchanged
+            result.append(f.raw.data(), f.raw.size());
+            continue;
+        }
+        found_graph = true;
+        std::string new_graph = graph;
+        for (const auto& g : pb::parse(f.bytes)) {
+            if (g.number == 11 && g.wire == pb::BYTES) {   // graph.input: drop the one we now produce
+                std::string_view name;
+                for (const auto& v : pb::parse(g.bytes)) {
+                    if (v.number == 1) name = v.bytes;
+                }
+                if (name == spec.input_name) {
+                    found_input = true;
+                    continue;
+                }
+            }
+            new_graph.append(g.raw.data(), g.raw.size());
+        }
+        pb::putBytes(result, 7, new_graph);
+    }
+    if (!found_graph || !found_input) throw std::runtime_error("graph input '" + spec.input_name + "' not found in model");
+    return result;
+}
+
+std::string readFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) throw std::runtime_error("cannot read " + path);
+    return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+}
+
+// ---------------- Benchmark ----------------
+double percentile(std::vector<double> v, double q) {
+    if (v.empty()) return 0.0;
+    std::sort(v.begin(), v.end());
+    return v[std::min(v.size() - 1, static_cast<size_t>(q * (v.size() - 1) + 0.5))];
+}
+
+// [1, N, 6] outputs with conf >= 0.25
+size_t countDetections(const Ort::Value& output) {
+    auto info = output.GetTensorTypeAndShapeInfo();
+    const float* data = output.GetTensorData<float>();
+    size_t count = 0;
+    for (size_t i = 0; i + 5 < info.GetElementCount(); i += 6) count += data[i + 4] >= 0.25f;
+    return count;
+}
+
+// ---------------- Main ----------------
+int main(int argc, char** argv) {
+    try {
+        std::cout << "--- In-Graph Preprocessing Demo ---" << std::endl;
+
+        std::vector<std::string> args;
+        bool resize = true;
+        for (int i = 1; i < argc; i++) {
+            if (std::string(argv[i]) == "--no-resize") resize = false;
+            else args.push_back(argv[i]);
+        }
+        const std::string model_path = args.size() > 0 ? args[0] : "/assets/models/yolov10n.onnx";
+        const std::string wrapped_path = args.size() > 1 ? args[1] : "/assets/models/yolov10n_uint8_nhwc.onnx";
+        const int runs = args.size() > 2 ? std::max(1, std::atoi(args[2].c_str())) : 30;
+        const std::string image_path = "/assets/images/car.png";
+
+        Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "InGraphPreprocessDemo");
+        Ort::SessionOptions session_options;
+        session_options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+        Ort::Session host_session(env, model_path.c_str(), session_options);
+
+        // 1. Wrap the model
+        Ort::AllocatorWithDefaultOptions allocator;
+        PreprocessSpec spec;
+        spec.resize = resize;
+        spec.input_name = host_session.GetInputNameAllocated(0, allocator).get();
+        std::vector<int64_t> in_shape = host_session.GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+        if (in_shape.size() != 4) throw std::runtime_error("expected a [N, C, H, W] input");
+        spec.channels = in_shape[1] > 0 ? in_shape[1] : 3;
+        spec.height = in_shape[2] > 0 ? in_shape[2] : 640;
+        spec.width = in_shape[3] > 0 ? in_shape[3] : 640;
+
+        const std::string original = readFile(model_path);
+        const std::string wrapped = wrapModel(original, spec);
+        std::ofstream wrapped_file(wrapped_path, std::ios::binary);
+        wrapped_file.write(wrapped.data(), static_cast<std::streamsize>(wrapped.size()));
+        wrapped_file.close();
+        const bool saved = static_cast<bool>(wrapped_file);
+        if (!saved) std::cerr << " Warning: could not write " << wrapped_path << "; the benchmark uses the in-memory copy" << std::endl;
+        std::cout << "Wrapped " << model_path << " (" << original.size() << " bytes) -> "
+                  << (saved ? wrapped_path : std::string("memory")) << " (" << wrapped.size() << " bytes), input '"
+                  << spec.frame_name << "' uint8 NHWC" << (resize ? " with in-graph Resize" : "") << std::endl;
+
+        Ort::Session graph_session(env, wrapped.data(), wrapped.size(), session_options);
+
+        auto output_name = host_session.GetOutputNameAllocated(0, allocator);
+        const char* output_names[] = {output_name.get()};
+        const char* host_input_names[] = {spec.input_name.c_str()};
+        const char* graph_input_names[] = {spec.frame_name.c_str()};
+        Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+
+        cv::Mat image = cv::imread(image_path);
+        if (image.empty()) {
+            std::cerr << "Error: could not load image at " << image_path << std::endl;
+            return -1;
+        }
+        const cv::Size model_size(static_cast<int>(spec.width), static_cast<int>(spec.height));
+        const int plane = model_size.area();
+
+        // 2. Host vs in-graph preprocessing per frame size
+        std::printf("\n%-10s | %13s | %15s | %7s | %s\n", "frame", "host p50 ms", "in-graph p50 ms", "speedup", "detections host / in-graph");
+        for (const cv::Size frame_size : {cv::Size(640, 640), cv::Size(1280, 720), cv::Size(1920, 1080)}) {
+            cv::Mat frame;
+            cv::resize(image, frame, frame_size);
+
+            // Host: as in 10.Ort_Detect_YOLOv10n.cpp
+            std::vector<double> host_ms;
+            size_t host_dets = 0;
+            std::vector<float> chw(static_cast<size_t>(plane) * 3);
+            for (int r = 0; r <= runs; r++) {
+                auto t0 = Clock::now();
+                cv::Mat resized;
+                cv::resize(frame, resized, model_size);
+                resized.convertTo(resized, CV_32F, 1.0 / 255.0);
+                std::vector<cv::Mat> channels(3);
+                cv::split(resized, channels);
+                for (int c = 0; c < 3; c++) std::memcpy(chw.data() + c * plane, channels[c].data, plane * sizeof(float));
+                std::vector<int64_t> shape = {1, 3, spec.height, spec.width};
+                Ort::Value input = Ort::Value::CreateTensor<float>(memory_info, chw.data(), chw.size(), shape.data(), shape.size());
+                auto outputs = host_session.Run(Ort::RunOptions{nullptr}, host_input_names, &input, 1, output_names, 1);
+                if (r > 0) host_ms.push_back(std::chrono::duration<double, std::milli>(Clock::now() - t0).count());   // r == 0 is warm-up
+                host_dets = countDetections(outputs[0]);
+            }
+
+            // In-graph: bind the cv::Mat bytes as they are
+            std::vector<double> graph_ms;
+            size_t graph_dets = 0;
+            for (int r = 0; r <= runs; r++) {
+                auto t0 = Clock::now();
+                cv::Mat src = frame;
+                if (!resize) cv::resize(frame, src, model_size);
+                if (!src.isContinuous()) src = src.clone();
+                std::vector<int64_t> shape = {1, src.rows, src.cols, src.channels()};
+                Ort::Value input = Ort::Value::CreateTensor<uint8_t>(memory_info, src.data, src.total() * src.channels(),
+                                                                     shape.data(), shape.size());
+                auto outputs = graph_session.Run(Ort::RunOptions{nullptr}, graph_input_names, &input, 1, output_names, 1);
+                if (r > 0) graph_ms.push_back(std::chrono::duration<double, std::milli>(Clock::now() - t0).count());
+                graph_dets = countDetections(outputs[0]);
+            }
+
+            const double host_p50 = percentile(host_ms, 0.50), graph_p50 = percentile(graph_ms, 0.50);
+            std::printf("%4dx%-5d | %13.2f | %15.2f | %6.2fx | %zu / %zu\n", frame_size.width, frame_size.height, host_p50,
+                        graph_p50, graph_p50 > 0 ? host_p50 / graph_p50 : 0.0, host_dets, graph_dets);
+        }
+    }
+    catch (const Ort::Exception& e) {
+        std::cerr << "ONNX Runtime error: " << e.what() << std::endl;
+        return -1;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Standard exception: " << e.what() << std::endl;
+        return -1;
+    }
+
+    std::cout << "--- Demo Complete ---" << std::endl;
+    return 0;
+}
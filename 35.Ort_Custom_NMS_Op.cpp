@@ -0,0 +1,612 @@
+/*
+
+Why do we need a custom decode + NMS operator?
+----------------------------------------------------
+YOLO exports without built-in NMS (YOLOv5/v8/v11 heads, [1, 4 + classes, anchors] = [1,84,8400] for COCO) end the graph at the
+raw candidate tensor. The application then walks 8400 anchors x 80 classes, decodes boxes and runs NMS one detection at a time on
+the calling thread (22.Ort_YOLO_Postprocess.cpp makes that loop fast, but it still runs outside ORT and single-threaded).
+
+YoloDecodeNms is a custom operator, registered in the "ortdemo" domain with Ort::CustomOpDomain. It does this work inside the graph:
+
+    input   predictions [B, 4 + C, N] float   (cx, cy, w, h, then C class scores per anchor)
+    output  detections  [K, 7] float           (batch_index, x1, y1, x2, y2, score, class_id), sorted by score per batch
+    attrs   conf_threshold (0.25), iou_threshold (0.45), max_detections (300 per batch image)
+
+    1. Decode + filter : anchors are split into chunks of 1024 per batch image and spread over ORT's intra-op thread pool
+                         (KernelContext::ParallelFor). Each chunk finds the best class with a class-outer loop over contiguous rows.
+    2. NMS             : candidates are grouped by (batch, class). The groups are independent, so they run in parallel too. Each
+                         group does greedy suppression in score order.
+    3. Output          : per batch, kept boxes sorted by score and capped at max_detections. Only these K rows leave ORT.
+
+The tool adds the operator to a model by editing its protobuf (the same wire-format helpers as 34.Ort_InGraph_Preprocess.cpp):
+one node after the model's output, a new graph output and an opset import for the "ortdemo" domain.
+
+Two ways to use the operator:
+
+    - In process     : session_options.Add(domain), as in this demo.
+    - Shared library : build with -DNMS_OP_LIBRARY -shared -fPIC (main is left out) and load it with
+                       session_options.RegisterCustomOpsLibrary("libyolo_nms_op.so"). ORT calls RegisterCustomOps().
+
+The benchmark:
+
+    1. Synthetic : a graph that contains only YoloDecodeNms, fed a synthetic [1,84,8400] head (as in 22.Ort_YOLO_Postprocess.cpp).
+                   It checks the output against a serial application-side reference and compares their latency.
+    2. Model     : with a raw-head YOLO model (argv[1], e.g. yolov8n.onnx), end-to-end model Run + application postprocessing
+                   vs the wrapped model that returns final detections.
+
+Usage:
+    ./ort_custom_nms_op [yolo_raw_head.onnx] [runs]
+
+*/
+
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <functional>
+#include <chrono>
+#include <random>
+#include <mutex>
+#include <thread>
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#ifdef NMS_OP_LIBRARY
+#define ORT_API_MANUAL_INIT
+#endif
+#include <onnxruntime_cxx_api.h>
+
+using Clock = std::chrono::steady_clock;
+
+static const char* kDomain = "ortdemo";
+
+// ---------------- Decode + NMS ----------------
+struct NmsConfig {
+    float conf_threshold = 0.25f;
+    float iou_threshold = 0.45f;
+    int64_t max_detections = 300;
+};
+
+struct Box {
+    float x1, y1, x2, y2, score;
+    int32_t cls, batch;
+};
+
+// Runs fn(i) for i in [0, n), possibly in parallel
+using ParallelFor = std::function<void(size_t n, const std::function<void(size_t)>& fn)>;
+
+inline float iou(const Box& a, const Box& b) {
+    const float iw = std::max(0.f, std::min(a.x2, b.x2) - std::max(a.x1, b.x1));
+    const float ih = std::max(0.f, std::min(a.y2, b.y2) - std::max(a.y1, b.y1));
+    const float inter = iw * ih;
+    const float uni = (a.x2 - a.x1) * (a.y2 - a.y1) + (b.x2 - b.x1) * (b.y2 - b.y1) - inter;
+    return uni > 0.f ? inter / uni : 0.f;
+}
+
+// data: [batch, 4 + classes, anchors]. Returns the kept boxes, per batch sorted by score.
+std::vector<Box> decodeNms(const float* data, int64_t batch, int64_t channels, int64_t anchors, const NmsConfig& cfg,
+                           const ParallelFor& parallel_for) {
+    constexpr int64_t kChunk = 1024;
+    const int64_t classes = channels - 4;
+    const int64_t chunks_per_image = (anchors + kChunk - 1) / kChunk;
+
+    // 1. Decode + filter, one task per (batch, anchor chunk)
+    std::vector<std::vector<Box>> chunk_boxes(static_cast<size_t>(batch * chunks_per_image));
+    parallel_for(chunk_boxes.size(), [&](size_t task) {
+        const int64_t b = static_cast<int64_t>(task) / chunks_per_image;
+        const int64_t begin = (static_cast<int64_t>(task) % chunks_per_image) * kChunk;
+        const int64_t count = std::min(kChunk, anchors - begin);
+        const float* image = data + b * channels * anchors;
+
+        float best[kChunk];
+        int32_t best_cls[kChunk];
+        std::fill(best, best + count, -1.f);
+        std::fill(best_cls, best_cls + count, 0);
+        for (int64_t c = 0; c < classes; c++) {
+            const float* row = image + (4 + c) * anchors + begin;
+            for (int64_t a = 0; a < count; a++) {
+                if (row[a] > best[a]) {
+                    best[a] = row[a];
+                    best_cls[a] = static_cast<int32_t>(c);
+                }
+            }
+        }
+        auto& out = chunk_boxes[task];
+        for (int64_t a = 0; a < count; a++) {
+            if (best[a] < cfg.conf_threshold) continue;
+            const int64_t i = begin + a;
+            const float cx = image[i], cy = image[anchors + i], w = image[2 * anchors + i], h = image[3 * anchors + i];
+            out.push_back({cx - w / 2, cy - h / 2, cx + w / 2, cy + h / 2, best[a], best_cls[a], static_cast<int32_t>(b)});
+        }
+    });
+
+    std::vector<Box> boxes;
+    for (auto& chunk : chunk_boxes) boxes.insert(boxes.end(), chunk.begin(), chunk.end());
+
+    // 2. Group by (batch, class), highest score first, then suppress each group in parallel
+    std::sort(boxes.begin(), boxes.end(), [](const Box& a, const Box& b) {
+        if (a.batch != b.batch) return a.batch < b.batch;
+        if (a.cls != b.cls) return a.cls < b.cls;
+        return a.score > b.score;
+    });
+    std::vector<std::pair<size_t, size_t>> groups;
+    for (size_t i = 0; i < boxes.size();) {
+        size_t j = i + 1;
+        while (j < boxes.size() && boxes[j].batch == boxes[i].batch && boxes[j].cls == boxes[i].cls) j++;
+        groups.emplace_back(i, j);
+        i = j;
+    }
+    std::vector<uint8_t> keep(boxes.size(), 1);
+    parallel_for(groups.size(), [&](size_t g) {
+        const auto [begin, end] = groups[g];
+        for (size_t i = begin; i < end; i++) {
+            if (!keep[i]) continue;
+            for (size_t j = i + 1; j < end; j++) {
+                if (keep[j] && iou(boxes[i], boxes[j]) > cfg.iou_threshold) keep[j] = 0;
+            }
+        }
+    });
+
+    // 3. Kept boxes per batch, by score, capped
+    std::vector<Box> result;
+    for (int64_t b = 0; b < batch; b++) {
+        std::vector<Box> kept;
+        for (size_t i = 0; i < boxes.size(); i++) {
+            if (keep[i] && boxes[i].batch == b) kept.push_back(boxes[i]);
+        }
+        std::stable_sort(kept.begin(), kept.end(), [](const Box& x, const Box& y) { return x.score > y.score; });
+        if (static_cast<int64_t>(kept.size()) > cfg.max_detections) kept.resize(static_cast<size_t>(cfg.max_detections));
+        result.insert(result.end(), kept.begin(), kept.end());
+    }
+    return result;
+}
+
+// ---------------- Custom op ----------------
+template <typename T>
+T attributeOr(const Ort::ConstKernelInfo& info, const char* name, T fallback) {
+    try {
+        return info.GetAttribute<T>(name);
+    } catch (const Ort::Exception&) {
+        return fallback;   // attribute not set on the node
+    }
+}
+
+struct YoloDecodeNmsKernel {
+    explicit YoloDecodeNmsKernel(const OrtKernelInfo* info) {
+        Ort::ConstKernelInfo kernel_info(info);
+        cfg_.conf_threshold = attributeOr<float>(kernel_info, "conf_threshold", cfg_.conf_threshold);
+        cfg_.iou_threshold = attributeOr<float>(kernel_info, "iou_threshold", cfg_.iou_threshold);
+        cfg_.max_detections = attributeOr<int64_t>(kernel_info, "max_detections", cfg_.max_detections);
+    }
+
+    OrtStatusPtr ComputeV2(OrtKernelContext* context) {
+        try {
+            compute(context);
+        } catch (const Ort::Exception& e) {
+            return Ort::Status(e).release();
+        } catch (const std::exception& e) {
+            return Ort::Status(e.what(), ORT_FAIL).release();
+        }
+        return nullptr;
+    }
+
+private:
+    void compute(OrtKernelContext* context) {
+        Ort::KernelContext ctx(context);
+        auto input = ctx.GetInput(0);
+        const std::vector<int64_t> shape = input.GetTensorTypeAndShapeInfo().GetShape();
+        if (shape.size() != 3 || shape[1] < 5) {
+            throw Ort::Exception("YoloDecodeNms expects predictions of shape [B, 4 + classes, anchors]", ORT_INVALID_ARGUMENT);
+        }
+
+        // ParallelFor takes a plain function pointer, so the std::function travels through usr_data
+        ParallelFor parallel_for = [&ctx](size_t n, const std::function<void(size_t)>& fn) {
+            if (n == 0) return;
+            auto trampoline = [](void* usr_data, size_t i) { (*static_cast<const std::function<void(size_t)>*>(usr_data))(i); };
+            ctx.ParallelFor(trampoline, n, 0, const_cast<std::function<void(size_t)>*>(&fn));
+        };
+        const std::vector<Box> boxes = decodeNms(input.GetTensorData<float>(), shape[0], shape[1], shape[2], cfg_, parallel_for);
+
+        const std::vector<int64_t> out_shape = {static_cast<int64_t>(boxes.size()), 7};
+        float* out = ctx.GetOutput(0, out_shape).GetTensorMutableData<float>();
+        for (const auto& box : boxes) {
+            const float row[7] = {static_cast<float>(box.batch), box.x1, box.y1, box.x2, box.y2, box.score,
+                                  static_cast<float>(box.cls)};
+            out = std::copy(row, row + 7, out);
+        }
+    }
+
+    NmsConfig cfg_;
+};
+
+// WithStatus = true: errors in Compute come back as an OrtStatus instead of an exception across the C API
+struct YoloDecodeNmsOp : Ort::CustomOpBase<YoloDecodeNmsOp, YoloDecodeNmsKernel, true> {
+    OrtStatusPtr CreateKernelV2(const OrtApi& /*api*/, const OrtKernelInfo* info, void** kernel) const {
+        *kernel = new YoloDecodeNmsKernel(info);
+        return nullptr;
+    }
+    const char* GetName() const { return "YoloDecodeNms"; }
+    const char* GetExecutionProviderType() const { return "CPUExecutionProvider"; }
+    size_t GetInputTypeCount() const { return 1; }
+    ONNXTensorElementDataType GetInputType(size_t) const { return ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT; }
+    size_t GetOutputTypeCount() const { return 1; }
+    ONNXTensorElementDataType GetOutputType(size_t) const { return ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT; }
+};
+
+// The op and its domain must outlive every session that uses them
+Ort::CustomOpDomain& customOpDomain() {
+    static YoloDecodeNmsOp op;
+    static Ort::CustomOpDomain domain(kDomain);
+    static std::once_flag once;
+    std::call_once(once, [] { domain.Add(&op); });
+    return domain;
+}
+
+// Entry point for session_options.RegisterCustomOpsLibrary()
+extern "C" OrtStatus* ORT_API_CALL RegisterCustomOps(OrtSessionOptions* options, const OrtApiBase* api_base) {
+#ifdef NMS_OP_LIBRARY
+    Ort::InitApi(api_base->GetApi(ORT_API_VERSION));
+#else
+    (void)api_base;
+#endif
+    try {
+        Ort::UnownedSessionOptions(options).Add(customOpDomain());
+    } catch (const Ort::Exception& e) {
+        return Ort::Status(e).release();
+    }
+    return nullptr;
+}
+
+#ifndef NMS_OP_LIBRARY
+
+// ---------------- Model editing (protobuf wire format) ----------------
+namespace pb {
+enum Wire { VARINT = 0, FIXED64 = 1, BYTES = 2, FIXED32 = 5 };
+
+struct Field {
+    uint32_t number;
+    uint32_t wire;
+    std::string_view bytes;  // BYTES payload
+    std::string_view raw;    // the whole field, tag included
+};
+
+void putVarint(std::string& out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<char>((v & 0x7f) | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<char>(v));
+}
+
+void putTag(std::string& out, uint32_t field, Wire wire) { putVarint(out, (static_cast<uint64_t>(field) << 3) | wire); }
+
+void putInt(std::string& out, uint32_t field, int64_t v) {
+    putTag(out, field, VARINT);
+    putVarint(out, static_cast<uint64_t>(v));
+}
+
+void putFloat(std::string& out, uint32_t field, float v) {
+    putTag(out, field, FIXED32);
+    char bytes[4];
+    std::memcpy(bytes, &v, 4);   // little-endian hosts
+    out.append(bytes, 4);
+}
+
+void putBytes(std::string& out, uint32_t field, std::string_view bytes) {
+    putTag(out, field, BYTES);
+    putVarint(out, bytes.size());
+    out.append(bytes.data(), bytes.size());
+}
+
+uint64_t getVarint(std::string_view in, size_t& pos) {
+    uint64_t v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (pos >= in.size()) throw std::runtime_error("truncated protobuf varint");
+        const uint8_t b = static_cast<uint8_t>(in[pos++]);
+        v |= static_cast<uint64_t>(b & 0x7f) << shift;
+        if (!(b & 0x80)) return v;
+    }
+    throw std::runtime_error("malformed protobuf varint");
+}
+
+std::vector<Field> parse(std::string_view msg) {
+    std::vector<Field> fields;
+    size_t pos = 0;
+    while (pos < msg.size()) {
+        const size_t begin = pos;
+        const uint64_t tag = getVarint(msg, pos);
+        Field f{static_cast<uint32_t>(tag >> 3), static_cast<uint32_t>(tag & 7), {}, {}};
+        switch (f.wire) {
+            case VARINT: getVarint(msg, pos); break;
+            case FIXED64: pos += 8; break;
+            case FIXED32: pos += 4; break;
+            case BYTES: {
+                const uint64_t len = getVarint(msg, pos);
+                if (len > msg.size() - pos) throw std::runtime_error("truncated protobuf field");
+                f.bytes = msg.substr(pos, len);
+                pos += len;
+                break;
+            }
+            default: throw std::runtime_error("unsupported protobuf wire type");
+        }
+        if (pos > msg.size()) throw std::runtime_error("truncated protobuf field");
+        f.raw = msg.substr(begin, pos - begin);
+        fields.push_back(f);
+    }
+    return fields;
+}
+}  // namespace pb
+
+// Field numbers and enums from onnx.proto
+namespace onnx {
+enum DataType { FLOAT = 1 };
+enum AttrType { ATTR_FLOAT = 1, ATTR_INT = 2 };
+
+// Dimensions >= 0 are fixed, negative ones get the symbolic name `params[i]`
+std::string valueInfo(const std::string& name, const std::vector<int64_t>& dims, const std::vector<std::string>& params) {
+    std::string shape;
+    for (size_t i = 0; i < dims.size(); i++) {
+        std::string dim;
+        if (dims[i] >= 0) pb::putInt(dim, 1, dims[i]);
+        else pb::putBytes(dim, 2, params[i]);
+        pb::putBytes(shape, 1, dim);
+    }
+    std::string tensor_type;
+    pb::putInt(tensor_type, 1, FLOAT);
+    pb::putBytes(tensor_type, 2, shape);
+    std::string type_proto;
+    pb::putBytes(type_proto, 1, tensor_type);
+    std::string info;
+    pb::putBytes(info, 1, name);
+    pb::putBytes(info, 2, type_proto);
+    return info;
+}
+
+std::string opsetImport(const std::string& domain, int64_t version) {
+    std::string o;
+    pb::putBytes(o, 1, domain);
+    pb::putInt(o, 2, version);
+    return o;
+}
+
+std::string nmsNode(const std::string& input, const std::string& output, const NmsConfig& cfg) {
+    std::string conf, iou, max_det;
+    pb::putBytes(conf, 1, "conf_threshold");
+    pb::putFloat(conf, 2, cfg.conf_threshold);
+    pb::putInt(conf, 20, ATTR_FLOAT);
+    pb::putBytes(iou, 1, "iou_threshold");
+    pb::putFloat(iou, 2, cfg.iou_threshold);
+    pb::putInt(iou, 20, ATTR_FLOAT);
+    pb::putBytes(max_det, 1, "max_detections");
+    pb::putInt(max_det, 3, cfg.max_detections);
+    pb::putInt(max_det, 20, ATTR_INT);
+
+    std::string n;
+    pb::putBytes(n, 1, input);
+    pb::putBytes(n, 2, output);
+    pb::putBytes(n, 3, "yolo_decode_nms");
+    pb::putBytes(n, 4, "YoloDecodeNms");
+    for (const auto& a : {conf, iou, max_det}) pb::putBytes(n, 5, a);
+    pb::putBytes(n, 7, kDomain);
+    return n;
+}
+}  // namespace onnx
+
+// A model with one YoloDecodeNms node: predictions [batch, channels, anchors] -> detections [K, 7]
+std::string buildNmsOnlyModel(int64_t channels, int64_t anchors, const NmsConfig& cfg) {
+    std::string graph;
+    pb::putBytes(graph, 1, onnx::nmsNode("predictions", "detections", cfg));
+    pb::putBytes(graph, 2, "yolo_decode_nms_only");
+    pb::putBytes(graph, 11, onnx::valueInfo("predictions", {-1, channels, anchors}, {"batch", "", ""}));
+    pb::putBytes(graph, 12, onnx::valueInfo("detections", {-1, 7}, {"num_detections", ""}));
+
+    std::string model;
+    pb::putInt(model, 1, 8);   // ir_version
+    pb::putBytes(model, 2, "ort-tutorial");
+    pb::putBytes(model, 7, graph);
+    pb::putBytes(model, 8, onnx::opsetImport("", 17));
+    pb::putBytes(model, 8, onnx::opsetImport(kDomain, 1));
+    return model;
+}
+
+// Appends YoloDecodeNms after `output_name` and makes "detections" the only graph output
+std::string appendNms(const std::string& model, const std::string& output_name, const NmsConfig& cfg) {
+    std::string result;
+    bool found_graph = false;
+    for (const auto& f : pb::parse(model)) {
+        if (f.number != 7 || f.wire != pb::BYTES) {
+            result.append(f.raw.data(), f.raw.size());
+            continue;
+        }
+        found_graph = true;
+        std::string graph;
+        for (const auto& g : pb::parse(f.bytes)) {
+            if (g.number == 12) continue;   // graph.output, replaced below
+            graph.append(g.raw.data(), g.raw.size());
+        }
+        pb::putBytes(graph, 1, onnx::nmsNode(output_name, "detections", cfg));
+        pb::putBytes(graph, 12, onnx::valueInfo("detections", {-1, 7}, {"num_detections", ""}));
+        pb::putBytes(result, 7, graph);
+    }
+    if (!found_graph) throw std::runtime_error("model has no graph");
+    pb::putBytes(result, 8, onnx::opsetImport(kDomain, 1));
+    return result;
+}
+
+std::string readFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) throw std::runtime_error("cannot read " + path);
+    return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+}
+
+// ---------------- Benchmark helpers ----------------
+// Application-side reference: same algorithm, serial
+std::vector<Box> decodeNmsSerial(const float* data, int64_t batch, int64_t channels, int64_t anchors, const NmsConfig& cfg) {
+    return decodeNms(data, batch, channels, anchors, cfg, [](size_t n, const std::function<void(size_t)>& fn) {
+        for (size_t i = 0; i < n; i++) fn(i);
+    });
+}
+
+// Raw head with `objects` objects, each seen by ~40 neighbouring anchors, background scores ~0.01
+std::vector<float> syntheticRaw(int num_classes, int n, int objects, std::mt19937& rng) {
+    std::vector<float> data(static_cast<size_t>(4 + num_classes) * n);
+    std::uniform_real_distribution<float> pos(0.f, 640.f), size(10.f, 200.f), low(0.f, 0.02f), jitter(-4.f, 4.f), high(0.5f, 0.95f);
+    for (int a = 0; a < n; a++) {
+        data[a] = pos(rng); data[n + a] = pos(rng); data[2 * n + a] = size(rng); data[3 * n + a] = size(rng);
+    }
+    for (size_t i = 4 * static_cast<size_t>(n); i < data.size(); i++) data[i] = low(rng);
+    for (int o = 0; o < objects; o++) {
+        float cx = pos(rng), cy = pos(rng), w = size(rng), h = size(rng);
+        int cls = static_cast<int>(rng() % num_classes);
+        for (int k = 0; k < 40; k++) {
+            int a = static_cast<int>(rng() % n);
+            data[a] = cx + jitter(rng); data[n + a] = cy + jitter(rng);
+            data[2 * n + a] = w + jitter(rng); data[3 * n + a] = h + jitter(rng);
+            data[static_cast<size_t>(4 + cls) * n + a] = high(rng);
+        }
+    }
+    return data;
+}
+
+double percentile(std::vector<double> v, double q) {
+    if (v.empty()) return 0.0;
+    std::sort(v.begin(), v.end());
+    return v[std::min(v.size() - 1, static_cast<size_t>(q * (v.size() - 1) + 0.5))];
+}
+
+// Largest absolute difference between op rows [K, 7] and reference boxes; infinity if the counts differ
+float compare(const Ort::Value& detections, const std::vector<Box>& reference) {
+    auto info = detections.GetTensorTypeAndShapeInfo();
+    if (info.GetElementCount() != reference.size() * 7) return INFINITY;
+    const float* rows = detections.GetTensorData<float>();
+    float diff = 0.f;
+    for (size_t i = 0; i < reference.size(); i++) {
+        const Box& b = reference[i];
+        const float ref[7] = {static_cast<float>(b.batch), b.x1, b.y1, b.x2, b.y2, b.score, static_cast<float>(b.cls)};
+        for (int k = 0; k < 7; k++) diff = std::max(diff, std::fabs(rows[i * 7 + k] - ref[k]));
+    }
+    return diff;
+}
+
+// ---------------- Main ----------------
+int main(int argc, char** argv) {
+    try {
+        std::cout << "--- Custom Decode + NMS Operator Demo ---" << std::endl;
+
+        const std::string model_path = argc > 1 ? argv[1] : "";
+        const int runs = argc > 2 ? std::max(1, std::atoi(argv[2])) : 50;
+        const int threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        const NmsConfig cfg;
+
+        Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "CustomNmsOpDemo");
+        Ort::SessionOptions session_options;
+        session_options.SetIntraOpNumThreads(threads);
+        session_options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+        session_options.Add(customOpDomain());
+        Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+        std::cout << "Domain '" << kDomain << "', op YoloDecodeNms | intra-op threads: " << threads << std::endl;
+
+        // 1. Synthetic [1,84,8400] head through an op-only graph vs the serial reference
+        {
+            const int classes = 80, anchors = 8400;
+            std::mt19937 rng(42);
+            std::vector<float> head = syntheticRaw(classes, anchors, 30, rng);
+            std::vector<int64_t> shape = {1, 4 + classes, anchors};
+
+            const std::string op_model = buildNmsOnlyModel(4 + classes, anchors, cfg);
+            Ort::Session session(env, op_model.data(), op_model.size(), session_options);
+            const char* input_names[] = {"predictions"};
+            const char* output_names[] = {"detections"};
+            Ort::Value input = Ort::Value::CreateTensor<float>(memory_info, head.data(), head.size(), shape.data(), shape.size());
+
+            std::vector<Box> reference;
+            std::vector<double> app_us, op_us;
+            float diff = 0.f;
+            for (int r = 0; r <= runs; r++) {
+                auto t0 = Clock::now();
+                reference = decodeNmsSerial(head.data(), 1, 4 + classes, anchors, cfg);
+                auto t1 = Clock::now();
+                auto outputs = session.Run(Ort::RunOptions{nullptr}, input_names, &input, 1, output_names, 1);
+                auto t2 = Clock::now();
+                if (r == 0) {   // warm-up, and the correctness check
+                    diff = compare(outputs[0], reference);
+                    continue;
+                }
+                app_us.push_back(std::chrono::duration<double, std::micro>(t1 - t0).count());
+                op_us.push_back(std::chrono::duration<double, std::micro>(t2 - t1).count());
+            }
+            std::printf("\nSynthetic head [1,%d,%d], 30 objects: %zu detections, max |op - reference| = %g\n",
+                        4 + classes, anchors, reference.size(), diff);
+            std::printf("%-26s | %9s\n", "postprocess", "p50 us");
+            std::printf("%-26s | %9.1f\n", "application (serial)", percentile(app_us, 0.50));
+            std::printf("%-26s | %9.1f\n", "YoloDecodeNms (Run)", percentile(op_us, 0.50));
+        }
+
+        // 2. Real raw-head model: model + application postprocess vs model with the op appended
+        if (!model_path.empty()) {
+            Ort::Session plain(env, model_path.c_str(), session_options);
+            Ort::AllocatorWithDefaultOptions allocator;
+            const std::string input_name = plain.GetInputNameAllocated(0, allocator).get();
+            const std::string output_name = plain.GetOutputNameAllocated(0, allocator).get();
+            std::vector<int64_t> in_shape = plain.GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+            for (size_t d = 0; d < in_shape.size(); d++) {
+                if (in_shape[d] < 0) in_shape[d] = d == 0 ? 1 : 640;
+            }
+            size_t count = 1;
+            for (auto d : in_shape) count *= static_cast<size_t>(d);
+
+            const std::string wrapped = appendNms(readFile(model_path), output_name, cfg);
+            Ort::Session fused(env, wrapped.data(), wrapped.size(), session_options);
+
+            std::vector<float> image(count);
+            std::mt19937 rng(7);
+            std::uniform_real_distribution<float> pixel(0.f, 1.f);
+            for (auto& v : image) v = pixel(rng);
+            Ort::Value input = Ort::Value::CreateTensor<float>(memory_info, image.data(), image.size(), in_shape.data(), in_shape.size());
+            const char* input_names[] = {input_name.c_str()};
+            const char* plain_outputs[] = {output_name.c_str()};
+            const char* fused_outputs[] = {"detections"};
+
+            std::vector<double> plain_ms, fused_ms;
+            size_t plain_dets = 0, fused_dets = 0;
+            for (int r = 0; r <= runs; r++) {
+                auto t0 = Clock::now();
+                auto raw = plain.Run(Ort::RunOptions{nullptr}, input_names, &input, 1, plain_outputs, 1);
+                const auto raw_shape = raw[0].GetTensorTypeAndShapeInfo().GetShape();
+                plain_dets = decodeNmsSerial(raw[0].GetTensorData<float>(), raw_shape[0], raw_shape[1], raw_shape[2], cfg).size();
+                auto t1 = Clock::now();
+                auto dets = fused.Run(Ort::RunOptions{nullptr}, input_names, &input, 1, fused_outputs, 1);
+                fused_dets = static_cast<size_t>(dets[0].GetTensorTypeAndShapeInfo().GetShape()[0]);
+                auto t2 = Clock::now();
+                if (r == 0) continue;   // warm-up
+                plain_ms.push_back(std::chrono::duration<double, std::milli>(t1 - t0).count());
+                fused_ms.push_back(std::chrono::duration<double, std::milli>(t2 - t1).count());
+            }
+            std::printf("\nModel %s\n", model_path.c_str());
+            std::printf("%-30s | %9s | %s\n", "pipeline", "p50 ms", "detections");
+            std::printf("%-30s | %9.2f | %zu\n", "Run + application NMS", percentile(plain_ms, 0.50), plain_dets);
+            std::printf("%-30s | %9.2f | %zu\n", "Run with YoloDecodeNms", percentile(fused_ms, 0.50), fused_dets);
+        } else {
+            std::cout << "\nNo raw-head model given (e.g. yolov8n.onnx), skipping the end-to-end comparison." << std::endl;
+        }
+    }
+    catch (const Ort::Exception& e) {
+        std::cerr << "ONNX Runtime error: " << e.what() << std::endl;
+        return -1;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Standard exception: " << e.what() << std::endl;
+        return -1;
+    }
+
+    std::cout << "--- Demo Complete ---" << std::endl;
+    return 0;
+}
+
+#endif  // NMS_OP_LIBRARY
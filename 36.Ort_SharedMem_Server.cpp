@@ -0,0 +1,624 @@
+/*
+
+Why do we need a shared-memory inference server?
+----------------------------------------------------
+Every demo binary (08.Ort_Session_Run.cpp, 10.Ort_Detect_YOLOv10n.cpp, ...) creates its own Ort::Session. When ten camera-ingest
+processes run on one host, that means ten copies of the weights, ten arenas and ten intra-op thread pools fighting for the same
+cores. 16.Ort_Inference_Server.cpp shares sessions between threads, but only inside one process.
+
+This file hosts the sessions in one local daemon. Clients in other processes talk to it through:
+
+    - a Unix domain socket for control messages only (a few hundred bytes per request)
+    - a shared-memory ring per client, created by the daemon with memfd_create and handed to the client over the socket
+      (SCM_RIGHTS). Both sides mmap it, so a 4.9 MB frame is written once by the client and read in place by ORT. It is never
+      copied through the socket.
+
+Ring layout: `slots` equal slots (default 4). Slot i holds the input tensor at offset 0 and the output tensor after it
+(64-byte aligned). The client writes a frame into a slot and sends {model, slot, shape}. The daemon wraps the slot memory in an
+Ort::Value (no copy) and runs the model. If the output shape is static, the output Ort::Value also wraps the slot, so ORT writes
+the result straight into shared memory. Otherwise the output is copied in once. The reply carries the output shape and offset.
+With one slot per in-flight request, a client can fill slot i+1 while slot i is being served (submit() / wait()). The daemon
+answers the requests of one connection in order. An InferenceClient is not thread-safe: use one per thread.
+
+Scope: float tensors, one input and one output per model (the shape of every model in /assets). The daemon serves each client
+connection on its own thread, and all of them share the sessions (Session::Run is thread-safe).
+
+    InferenceClient client("/tmp/ort_infer.sock");
+    float* in = client.inputSlot(0);                 // fill in place, or pass any pointer to infer()
+    auto result = client.infer(0, in, {1, 3, 640, 640});
+    result.data / result.shape                       // points into the slot, valid until the slot is reused
+
+    client.submit(0, 0, frame0, shape);              // pipelined: up to slots() requests in flight
+    client.submit(0, 1, frame1, shape);
+    auto r0 = client.wait(), r1 = client.wait();     // results in submission order
+
+Modes:
+    serve  : run the daemon
+    client : run requests against a running daemon
+    bench  : (default) fork a daemon, then compare in-process Run with 1..N client processes. Latency p50/p99 and RSS per
+             process are reported, each measured in its own forked child.
+
+Usage:
+    ./ort_shm_server bench  [model.onnx] [requests] [client processes]
+    ./ort_shm_server serve  <socket path> <model.onnx> [more models...]
+    ./ort_shm_server client <socket path> [requests]
+
+*/
+
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <deque>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <algorithm>
+#include <stdexcept>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <csignal>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <onnxruntime_cxx_api.h>
+
+using Clock = std::chrono::steady_clock;
+
+// ---------------- Protocol ----------------
+constexpr uint32_t kMagic = 0x4f525453;   // "ORTS"
+constexpr uint32_t kVersion = 1;
+constexpr int kMaxRank = 8;
+constexpr size_t kAlign = 64;
+
+struct Hello {
+    uint32_t magic, version;
+    uint32_t slots, num_models;
+    uint64_t slot_bytes;
+};
+
+struct Request {
+    uint32_t magic;
+    uint32_t model;
+    uint32_t slot;
+    uint32_t rank;
+    int64_t shape[kMaxRank];
+};
+
+struct Response {
+    uint32_t magic;
+    int32_t status;            // 0 = ok
+    uint32_t slot;
+    uint32_t rank;
+    int64_t shape[kMaxRank];
+    uint64_t output_offset;    // inside the slot
+    uint64_t output_count;     // floats
+    char error[128];
+};
+
+size_t alignUp(size_t n, size_t a) { return (n + a - 1) / a * a; }
+
+size_t elementCount(const int64_t* shape, size_t rank) {
+    size_t count = 1;
+    for (size_t i = 0; i < rank; i++) count *= static_cast<size_t>(shape[i]);
+    return count;
+}
+
+bool sendAll(int fd, const void* data, size_t size) {
+    const char* p = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t n = ::send(fd, p, size, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool recvAll(int fd, void* data, size_t size) {
+    char* p = static_cast<char*>(data);
+    while (size > 0) {
+        ssize_t n = ::recv(fd, p, size, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// Sends `data` plus one file descriptor (SCM_RIGHTS)
+bool sendWithFd(int sock, const void* data, size_t size, int fd) {
+    iovec iov{const_cast<void*>(data), size};
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))] = {};
+    msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+    std::memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+    return ::sendmsg(sock, &msg, MSG_NOSIGNAL) == static_cast<ssize_t>(size);
+}
+
+bool recvWithFd(int sock, void* data, size_t size, int* fd) {
+    iovec iov{data, size};
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))] = {};
+    msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    if (::recvmsg(sock, &msg, MSG_WAITALL) != static_cast<ssize_t>(size)) return false;
+    cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    if (!cmsg || cmsg->cmsg_type != SCM_RIGHTS) return false;
+    std::memcpy(fd, CMSG_DATA(cmsg), sizeof(int));
+    return true;
+}
+
+// ---------------- Daemon ----------------
+class InferenceDaemon {
+public:
+    InferenceDaemon(const std::vector<std::string>& model_paths, int intra_threads, uint32_t slots) : slots_(slots) {
+        Ort::SessionOptions session_options;
+        session_options.SetIntraOpNumThreads(intra_threads);
+        session_options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+
+        Ort::AllocatorWithDefaultOptions allocator;
+        for (const auto& path : model_paths) {
+            Model m;
+            m.session = std::make_unique<Ort::Session>(env_, path.c_str(), session_options);
+            m.input_name = m.session->GetInputNameAllocated(0, allocator).get();
+            m.output_name = m.session->GetOutputNameAllocated(0, allocator).get();
+            m.input_shape = m.session->GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+            m.output_shape = m.session->GetOutputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+            m.static_output = std::all_of(m.output_shape.begin(), m.output_shape.end(), [](int64_t d) { return d >= 0; });
+
+            // Slot size: default input (dynamic dims: batch 1, others 640) plus output
+            std::vector<int64_t> in = m.input_shape, out = m.output_shape;
+            for (size_t d = 0; d < in.size(); d++) in[d] = in[d] >= 0 ? in[d] : (d == 0 ? 1 : 640);
+            for (size_t d = 0; d < out.size(); d++) out[d] = out[d] >= 0 ? out[d] : (d == 0 ? 1 : 640);
+            const size_t bytes = alignUp(elementCount(in.data(), in.size()) * sizeof(float), kAlign) +
+                                 elementCount(out.data(), out.size()) * sizeof(float);
+            slot_bytes_ = std::max(slot_bytes_, alignUp(bytes, 4096));
+            models_.push_back(std::move(m));
+        }
+    }
+
+    // Blocks until the process is terminated
+    void serve(const std::string& socket_path) {
+        int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listener < 0) throw std::runtime_error("socket() failed");
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, socket_path.c_str(), sizeof(addr.sun_path) - 1);
+        ::unlink(socket_path.c_str());
+        if (::bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || ::listen(listener, 64) != 0) {
+            throw std::runtime_error("cannot listen on " + socket_path + ": " + std::strerror(errno));
+        }
+
+        while (true) {
+            int client = ::accept(listener, nullptr, nullptr);
+            if (client < 0) {
+                if (errno == EINTR) continue;
+                throw std::runtime_error(std::string("accept() failed: ") + std::strerror(errno));
+            }
+            std::thread(&InferenceDaemon::serveClient, this, client).detach();
+        }
+    }
+
+    size_t slotBytes() const { return slot_bytes_; }
+
+private:
+    struct Model {
+        std::unique_ptr<Ort::Session> session;
+        std::string input_name, output_name;
+        std::vector<int64_t> input_shape, output_shape;
+        bool static_output = false;
+    };
+
+    void serveClient(int sock) {
+        const size_t ring_bytes = slot_bytes_ * slots_;
+        int fd = ::memfd_create("ort_ring", MFD_CLOEXEC);
+        void* ring = MAP_FAILED;
+        if (fd >= 0 && ::ftruncate(fd, static_cast<off_t>(ring_bytes)) == 0) {
+            ring = ::mmap(nullptr, ring_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+        const Hello hello{kMagic, kVersion, slots_, static_cast<uint32_t>(models_.size()), slot_bytes_};
+        if (ring == MAP_FAILED || !sendWithFd(sock, &hello, sizeof(hello), fd)) {
+            std::cerr << "Client setup failed: " << std::strerror(errno) << std::endl;
+            if (ring != MAP_FAILED) ::munmap(ring, ring_bytes);
+            if (fd >= 0) ::close(fd);
+            ::close(sock);
+            return;
+        }
+        ::close(fd);   // the mapping keeps the memory alive
+
+        Request req{};
+        while (recvAll(sock, &req, sizeof(req))) {
+            Response resp{};
+            resp.magic = kMagic;
+            resp.slot = req.slot;
+            try {
+                handle(req, static_cast<char*>(ring) + static_cast<size_t>(req.slot) * slot_bytes_, resp);
+            } catch (const std::exception& e) {
+                resp.status = -1;
+                std::strncpy(resp.error, e.what(), sizeof(resp.error) - 1);
+            }
+            if (!sendAll(sock, &resp, sizeof(resp))) break;
+        }
+        ::munmap(ring, ring_bytes);
+        ::close(sock);
+    }
+
+    void handle(const Request& req, char* slot, Response& resp) {
+        if (req.magic != kMagic) throw std::runtime_error("bad request magic");
+        if (req.model >= models_.size()) throw std::runtime_error("unknown model index");
+        if (req.slot >= slots_) throw std::runtime_error("slot out of range");
+        if (req.rank == 0 || req.rank > kMaxRank) throw std::runtime_error("bad tensor rank");
+        Model& m = models_[req.model];
+
+        const size_t in_count = elementCount(req.shape, req.rank);
+        const size_t out_offset = alignUp(in_count * sizeof(float), kAlign);
+        if (out_offset > slot_bytes_) throw std::runtime_error("input does not fit in a slot");
+
+        Ort::Value input = Ort::Value::CreateTensor<float>(memory_info_, reinterpret_cast<float*>(slot), in_count, req.shape, req.rank);
+        const char* input_names[] = {m.input_name.c_str()};
+        const char* output_names[] = {m.output_name.c_str()};
+        float* out = reinterpret_cast<float*>(slot + out_offset);
+
+        std::vector<int64_t> out_shape;
+        const size_t static_count = m.static_output ? elementCount(m.output_shape.data(), m.output_shape.size()) : 0;
+        if (m.static_output && out_offset + static_count * sizeof(float) <= slot_bytes_) {
+            // ORT writes the result straight into shared memory
+            Ort::Value output = Ort::Value::CreateTensor<float>(memory_info_, out, static_count, m.output_shape.data(),
+                                                                m.output_shape.size());
+            m.session->Run(Ort::RunOptions{nullptr}, input_names, &input, 1, output_names, &output, 1);
+            out_shape = m.output_shape;
+        } else {
+            auto outputs = m.session->Run(Ort::RunOptions{nullptr}, input_names, &input, 1, output_names, 1);
+            auto info = outputs[0].GetTensorTypeAndShapeInfo();
+            out_shape = info.GetShape();
+            if (out_offset + info.GetElementCount() * sizeof(float) > slot_bytes_) throw std::runtime_error("output does not fit in a slot");
+            std::memcpy(out, outputs[0].GetTensorData<float>(), info.GetElementCount() * sizeof(float));
+        }
+
+        if (out_shape.size() > kMaxRank) throw std::runtime_error("output rank too large");
+        resp.rank = static_cast<uint32_t>(out_shape.size());
+        std::copy(out_shape.begin(), out_shape.end(), resp.shape);
+        resp.output_offset = out_offset;
+        resp.output_count = elementCount(out_shape.data(), out_shape.size());
+    }
+
+    Ort::Env env_{ORT_LOGGING_LEVEL_WARNING, "SharedMemDaemon"};
+    Ort::MemoryInfo memory_info_ = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+    std::vector<Model> models_;
+    uint32_t slots_;
+    size_t slot_bytes_ = 4096;
+};
+
+// ---------------- Client library ----------------
+class InferenceClient {
+public:
+    struct Result {
+        std::vector<int64_t> shape;
+        const float* data = nullptr;   // inside the slot, valid until the slot is reused
+        size_t count = 0;
+    };
+
+    explicit InferenceClient(const std::string& socket_path) {
+        sock_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, socket_path.c_str(), sizeof(addr.sun_path) - 1);
+        if (sock_ < 0 || ::connect(sock_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+            closeAll();
+            throw std::runtime_error("cannot connect to " + socket_path);
+        }
+        int fd = -1;
+        if (!recvWithFd(sock_, &hello_, sizeof(hello_), &fd) || hello_.magic != kMagic || hello_.version != kVersion) {
+            if (fd >= 0) ::close(fd);
+            closeAll();
+            throw std::runtime_error("bad handshake from " + socket_path);
+        }
+        ring_bytes_ = hello_.slot_bytes * hello_.slots;
+        void* ring = ::mmap(nullptr, ring_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (ring == MAP_FAILED) {
+            closeAll();
+            throw std::runtime_error("cannot map the shared ring");
+        }
+        ring_ = static_cast<char*>(ring);
+    }
+
+    ~InferenceClient() { closeAll(); }
+
+    InferenceClient(const InferenceClient&) = delete;
+    InferenceClient& operator=(const InferenceClient&) = delete;
+
+    uint32_t slots() const { return hello_.slots; }
+    size_t slotBytes() const { return hello_.slot_bytes; }
+    float* inputSlot(uint32_t slot) {
+        if (slot >= hello_.slots) throw std::out_of_range("slot " + std::to_string(slot) + " out of range");
+        return reinterpret_cast<float*>(ring_ + static_cast<size_t>(slot) * hello_.slot_bytes);
+    }
+
+    // Synchronous request on the next slot. `data` may already point at that slot's input, then nothing is copied.
+    Result infer(uint32_t model, const float* data, const std::vector<int64_t>& shape) {
+        const uint32_t slot = next_slot_;
+        next_slot_ = (next_slot_ + 1) % hello_.slots;
+        return infer(model, slot, data, shape);
+    }
+
+    Result infer(uint32_t model, uint32_t slot, const float* data, const std::vector<int64_t>& shape) {
+        if (!pending_.empty()) throw std::logic_error("infer() while submitted requests are pending; wait() for them first");
+        submit(model, slot, data, shape);
+        return wait();
+    }
+
+    // Pipelined use: submit() returns as soon as the request is sent, wait() returns results in submission order.
+    // Up to slots() requests may be in flight, each on its own slot, so the caller can fill slot i+1 while slot i is served.
+    void submit(uint32_t model, uint32_t slot, const float* data, const std::vector<int64_t>& shape) {
+        if (shape.empty() || shape.size() > kMaxRank) throw std::runtime_error("bad tensor rank");
+        const size_t bytes = elementCount(shape.data(), shape.size()) * sizeof(float);
+        if (bytes > hello_.slot_bytes) throw std::runtime_error("input does not fit in a slot");
+        float* dst = inputSlot(slot);
+        if (std::find(pending_.begin(), pending_.end(), slot) != pending_.end()) {
+            throw std::logic_error("slot " + std::to_string(slot) + " is still in flight");
+        }
+        if (data != dst) std::memcpy(dst, data, bytes);
+
+        Request req{};
+        req.magic = kMagic;
+        req.model = model;
+        req.slot = slot;
+        req.rank = static_cast<uint32_t>(shape.size());
+        std::copy(shape.begin(), shape.end(), req.shape);
+        if (!sendAll(sock_, &req, sizeof(req))) throw std::runtime_error("connection to the daemon lost");
+        pending_.push_back(slot);
+    }
+
+    Result wait() {
+        if (pending_.empty()) throw std::logic_error("wait() without a submitted request");
+        Response resp{};
+        if (!recvAll(sock_, &resp, sizeof(resp))) throw std::runtime_error("connection to the daemon lost");
+        const uint32_t slot = pending_.front();
+        pending_.pop_front();
+        if (resp.slot != slot) throw std::runtime_error("daemon answered out of order");
+        if (resp.status != 0) throw std::runtime_error(std::string("daemon error: ") + resp.error);
+
+        Result result;
+        result.shape.assign(resp.shape, resp.shape + resp.rank);
+        result.data = reinterpret_cast<const float*>(ring_ + static_cast<size_t>(slot) * hello_.slot_bytes + resp.output_offset);
+        result.count = resp.output_count;
+        return result;
+    }
+
+private:
+    void closeAll() {
+        if (ring_) ::munmap(ring_, ring_bytes_);
+        if (sock_ >= 0) ::close(sock_);
+        ring_ = nullptr;
+        sock_ = -1;
+    }
+
+    int sock_ = -1;
+    Hello hello_{};
+    char* ring_ = nullptr;
+    size_t ring_bytes_ = 0;
+    uint32_t next_slot_ = 0;
+    std::deque<uint32_t> pending_;   // slots of submitted requests, oldest first
+};
+
+// ---------------- Benchmark ----------------
+double rssMB() {
+    std::ifstream statm("/proc/self/statm");
+    long pages_total = 0, pages_resident = 0;
+    statm >> pages_total >> pages_resident;
+    return pages_resident * static_cast<double>(sysconf(_SC_PAGESIZE)) / (1024.0 * 1024.0);
+}
+
+double percentile(std::vector<double> v, double q) {
+    if (v.empty()) return 0.0;
+    std::sort(v.begin(), v.end());
+    return v[std::min(v.size() - 1, static_cast<size_t>(q * (v.size() - 1) + 0.5))];
+}
+
+std::vector<int64_t> defaultInputShape(const std::string& model_path) {
+    Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "ShapeProbe");
+    Ort::Session session(env, model_path.c_str(), Ort::SessionOptions{});
+    std::vector<int64_t> shape = session.GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+    for (size_t d = 0; d < shape.size(); d++) shape[d] = shape[d] >= 0 ? shape[d] : (d == 0 ? 1 : 640);
+    return shape;
+}
+
+std::vector<float> randomInput(const std::vector<int64_t>& shape, unsigned seed) {
+    std::vector<float> data(elementCount(shape.data(), shape.size()));
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(0.f, 1.f);
+    for (auto& v : data) v = dist(rng);
+    return data;
+}
+
+void printRow(const char* mode, int id, const std::vector<double>& ms) {
+    std::printf("%-12s | %6d | %8.3f | %8.3f | %7.1f\n", mode, id, percentile(ms, 0.50), percentile(ms, 0.99), rssMB());
+    std::fflush(stdout);
+}
+
+// Child process: its own session, `requests` Runs
+int runInProcess(const std::string& model_path, const std::vector<int64_t>& shape, int requests, int threads) {
+    Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "InProcess");
+    Ort::SessionOptions session_options;
+    session_options.SetIntraOpNumThreads(threads);
+    session_options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+    Ort::Session session(env, model_path.c_str(), session_options);
+
+    Ort::AllocatorWithDefaultOptions allocator;
+    auto input_name = session.GetInputNameAllocated(0, allocator);
+    auto output_name = session.GetOutputNameAllocated(0, allocator);
+    const char* input_names[] = {input_name.get()};
+    const char* output_names[] = {output_name.get()};
+    Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+
+    std::vector<float> frame = randomInput(shape, 1);
+    std::vector<double> ms;
+    for (int r = 0; r <= requests; r++) {
+        auto t0 = Clock::now();
+        Ort::Value input = Ort::Value::CreateTensor<float>(memory_info, frame.data(), frame.size(), shape.data(), shape.size());
+        auto outputs = session.Run(Ort::RunOptions{nullptr}, input_names, &input, 1, output_names, 1);
+        if (r > 0) ms.push_back(std::chrono::duration<double, std::milli>(Clock::now() - t0).count());   // r == 0 is warm-up
+    }
+    printRow("in-process", 0, ms);
+    return 0;
+}
+
+// Client process: frames are produced straight into the shared slot, as a camera decoder would
+int runClient(const std::string& socket_path, const std::vector<int64_t>& shape, int requests, int id) {
+    InferenceClient client(socket_path);
+    const std::vector<float> frame = randomInput(shape, 1);
+    std::vector<double> ms;
+    for (int r = 0; r <= requests; r++) {
+        const uint32_t slot = static_cast<uint32_t>(r) % client.slots();
+        auto t0 = Clock::now();
+        std::copy(frame.begin(), frame.end(), client.inputSlot(slot));   // stands in for decoding into the slot
+        auto result = client.infer(0, slot, client.inputSlot(slot), shape);
+        if (r > 0) ms.push_back(std::chrono::duration<double, std::milli>(Clock::now() - t0).count());
+        if (result.count == 0) throw std::runtime_error("empty result");
+    }
+    printRow("shm client", id, ms);
+    return 0;
+}
+
+template <typename Fn>
+pid_t forkChild(Fn&& fn) {
+    pid_t pid = fork();
+    if (pid != 0) return pid;
+    try {
+        std::exit(fn());
+    }
+    catch (const Ort::Exception& e) {
+        std::cerr << "ONNX Runtime error: " << e.what() << std::endl;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Standard exception: " << e.what() << std::endl;
+    }
+    std::exit(1);
+}
+
+bool waitChild(pid_t pid) {
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+// ---------------- Main ----------------
+int main(int argc, char** argv) {
+    const std::string mode = argc > 1 ? argv[1] : "bench";
+    const int cores = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+    try {
+        if (mode == "serve") {
+            if (argc < 4) throw std::runtime_error("usage: serve <socket path> <model.onnx> [more models...]");
+            InferenceDaemon daemon(std::vector<std::string>(argv + 3, argv + argc), cores, 4);
+            std::cout << "Serving " << (argc - 3) << " model(s) on " << argv[2] << ", slot " << daemon.slotBytes() / 1024
+                      << " KB x 4 per client" << std::endl;
+            daemon.serve(argv[2]);
+            return 0;
+        }
+        if (mode == "client") {
+            if (argc < 3) throw std::runtime_error("usage: client <socket path> [requests]");
+            const int requests = argc > 3 ? std::max(1, std::atoi(argv[3])) : 100;
+            // The daemon does not publish shapes, so this mode assumes a 640x640 detector
+            return runClient(argv[2], {1, 3, 640, 640}, requests, 0);
+        }
+    }
+    catch (const Ort::Exception& e) {
+        std::cerr << "ONNX Runtime error: " << e.what() << std::endl;
+        return -1;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Standard exception: " << e.what() << std::endl;
+        return -1;
+    }
+
+    // bench
+    std::cout << "--- Shared-Memory Inference Server Demo ---" << std::endl;
+    const std::string model_path = argc > 2 ? argv[2] : "/assets/models/yolov10n.onnx";
+    const int requests = argc > 3 ? std::max(1, std::atoi(argv[3])) : 50;
+    const int max_clients = argc > 4 ? std::max(1, std::atoi(argv[4])) : 4;
+    const std::string socket_path = "/tmp/ort_infer_" + std::to_string(::getpid()) + ".sock";
+
+    std::vector<int64_t> shape;
+    try {
+        shape = defaultInputShape(model_path);
+    } catch (const Ort::Exception& e) {
+        std::cerr << "ONNX Runtime error: " << e.what() << std::endl;
+        return -1;
+    }
+    std::cout << "Model: " << model_path << " | input " << elementCount(shape.data(), shape.size()) * sizeof(float) / 1024
+              << " KB | requests per process: " << requests << std::endl;
+    std::printf("\n%-12s | %6s | %8s | %8s | %7s\n", "mode", "client", "p50 ms", "p99 ms", "RSS MB");
+    std::fflush(stdout);
+
+    // 1. Baseline: the session inside the calling process
+    if (!waitChild(forkChild([&] { return runInProcess(model_path, shape, requests, cores); }))) {
+        std::cerr << "In-process run failed." << std::endl;
+        return -1;
+    }
+
+    // 2. Daemon, then 1 and max_clients concurrent client processes
+    pid_t daemon = forkChild([&] {
+        InferenceDaemon d({model_path}, cores, 4);
+        d.serve(socket_path);
+        return 0;
+    });
+    bool ok = false;
+    for (int i = 0; i < 600 && !ok; i++) {   // wait up to 60 s for the daemon to load the model and listen
+        try {
+            InferenceClient probe(socket_path);
+            ok = true;
+        } catch (const std::exception&) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+    }
+    if (!ok) {
+        std::cerr << "Daemon did not come up." << std::endl;
+        kill(daemon, SIGTERM);
+        waitChild(daemon);
+        return -1;
+    }
+
+    for (int clients : {1, max_clients}) {
+        if (clients == max_clients && max_clients == 1) break;
+        std::cout << "-- " << clients << " client process(es)" << std::endl;
+        std::vector<pid_t> pids;
+        for (int c = 0; c < clients; c++) {
+            pids.push_back(forkChild([&, c] { return runClient(socket_path, shape, requests, c); }));
+        }
+        for (pid_t pid : pids) ok = waitChild(pid) && ok;
+    }
+
+    kill(daemon, SIGTERM);
+    waitChild(daemon);
+    ::unlink(socket_path.c_str());
+    if (!ok) {
+        std::cerr << "A client process failed." << std::endl;
+        return -1;
+    }
+
+    std::cout << "\n--- Demo Complete ---" << std::endl;
+    return 0;
+}